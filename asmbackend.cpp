@@ -0,0 +1,268 @@
+#include "asmbackend.h"
+#include "cbackend.h"
+#include "ipo.h"
+#include "lowering.h"
+#include "regalloc.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+using x86::Operand;
+
+// Símbolos que uma função exportada não pode ter: as funções da libm chamadas
+// pelo código gerado e main (nem nomes com o prefixo neto_, da tabela de funções)
+const std::set<std::string> RESERVED = {"main", "pow", "log", "fma"};
+
+uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Constantes do arquivo inteiro (.LK0, .LK1, ...), sem repetições
+struct ConstantPool {
+    std::vector<double> values;
+    std::unordered_map<uint64_t, int> index;
+
+    std::string label(double value) {
+        auto it = index.find(bitsOf(value));
+        if (it != index.end()) return ".LK" + std::to_string(it->second);
+        int k = values.size();
+        values.push_back(value);
+        index[bitsOf(value)] = k;
+        return ".LK" + std::to_string(k);
+    }
+};
+
+// Saída da tradução compartilhada (lowering.h) em texto AT&T. As chamadas
+// entre funções usam o rótulo local da função, sem passar pela PLT
+class TextEmitter : public x86::Emitter {
+private:
+    std::ostringstream& out;
+    ConstantPool& pool;
+    std::string name;
+
+    void emit(const std::string& mnemonic, const std::string& operands = "") {
+        out << "    " << mnemonic;
+        if (!operands.empty()) out << std::string(mnemonic.size() < 8 ? 8 - mnemonic.size() : 1, ' ') << operands;
+        out << "\n";
+    }
+
+    static std::string gpr(int reg) {
+        switch (reg) {
+            case x86::RAX: return "%rax";
+            case x86::RCX: return "%rcx";
+            case x86::RSP: return "%rsp";
+            case x86::RBP: return "%rbp";
+            default: return "%rdi";
+        }
+    }
+
+    static std::string xmm(int reg) {
+        return "%xmm" + std::to_string(reg);
+    }
+
+    std::string text(const Operand& op) {
+        if (op.kind == Operand::REGISTER) return xmm(op.reg);
+        if (op.kind == Operand::MEMORY) return std::to_string(op.disp) + "(" + gpr(op.reg) + ")";
+        return pool.label(op.value) + "(%rip)";
+    }
+
+public:
+    TextEmitter(std::ostringstream& output, ConstantPool& constants) : out(output), pool(constants) {}
+
+    void beginFunction(const std::string& function) override {
+        name = function;
+        out << "    .globl  " << name << "\n";
+        out << "    .type   " << name << ", @function\n";
+        out << "    .p2align 4\n";
+        out << name << ":\n.Lf_" << name << ":\n";
+    }
+
+    void endFunction() override {
+        out << "    .size   " << name << ", .-" << name << "\n\n";
+    }
+
+    void prologue(int32_t frame) override {
+        emit("pushq", "%rbp");
+        emit("movq", "%rsp, %rbp");
+        emit("subq", "$" + std::to_string(frame) + ", %rsp");
+    }
+
+    void epilogue(bool frame) override {
+        if (frame) emit("leave");
+        emit("ret");
+    }
+
+    void sse(x86::Sse op, int reg, const Operand& src) override {
+        static const char* mnemonics[] = {"movsd", "movapd", "addsd", "subsd", "mulsd", "divsd", "sqrtsd"};
+        emit(mnemonics[static_cast<int>(op)], text(src) + ", " + xmm(reg));
+    }
+
+    void storeDouble(const Operand& dst, int reg) override {
+        emit("movsd", xmm(reg) + ", " + text(dst));
+    }
+
+    void fused(const std::string& op, int dst, int src1, const Operand& src2) override {
+        std::string mnemonic = op == "FMA" ? "vfmadd231sd" : op == "FMS" ? "vfmsub231sd" : "vfnmadd231sd";
+        emit(mnemonic, text(src2) + ", " + xmm(src1) + ", " + xmm(dst));
+    }
+
+    void load(int reg, const Operand& src) override { emit("movq", text(src) + ", " + gpr(reg)); }
+    void store(const Operand& dst, int reg) override { emit("movq", gpr(reg) + ", " + text(dst)); }
+    void flipSign(int reg) override { emit("btcq", "$63, " + gpr(reg)); }
+
+    void clear(int reg) override {
+        std::string low = "%e" + gpr(reg).substr(2);
+        emit("xorl", low + ", " + low);
+    }
+
+    void jumpIfZero(int reg) override {
+        emit("testq", gpr(reg) + ", " + gpr(reg));
+        emit("je", ".Lr_" + name);
+    }
+
+    void returnLabel() override { out << ".Lr_" << name << ":\n"; }
+
+    void callFunction(const std::string& callee) override { emit("call", ".Lf_" + callee); }
+
+    void callLibrary(x86::Library function) override {
+        emit("call", function == x86::Library::POW ? "pow@PLT" : function == x86::Library::LOG ? "log@PLT" : "fma@PLT");
+    }
+};
+
+} // namespace
+
+AsmBackend::AsmBackend(const AsmBackendOptions& opts) : options(opts) {}
+
+bool AsmBackend::generate(const std::vector<ThreeAddressCode>& code, std::string& source) {
+    errorMsg = "";
+    IRModule module = buildModule(code);
+
+    std::unordered_map<std::string, int> values;
+    std::unordered_map<std::string, size_t> arity;
+    for (const auto& func : module.functions) {
+        values[func.name] = 1;
+        arity[func.name] = func.params.size();
+        for (const auto& instr : func.body) {
+            if (instr.op != "RETURN") continue;
+            values[func.name] = splitArgs(instr.arg1).size();
+            break;
+        }
+    }
+    for (const auto& func : module.functions) {
+        if (RESERVED.count(func.name) || func.name.compare(0, 5, "neto_") == 0) {
+            errorMsg = "a função '" + func.name + "' não pode ser exportada (símbolo reservado)";
+            return false;
+        }
+        for (const auto& instr : func.body) {
+            if (instr.op != "CALL") continue;
+            if (!arity.count(instr.arg1)) {
+                errorMsg = "função '" + instr.arg1 + "' não existe";
+                return false;
+            }
+            size_t args = splitArgs(instr.arg2).size();
+            if (args != arity[instr.arg1]) {
+                errorMsg = "função '" + instr.arg1 + "' espera " + std::to_string(arity[instr.arg1]) +
+                           " argumento(s), mas " + std::to_string(args) + " foi(ram) fornecido(s)";
+                return false;
+            }
+        }
+    }
+    // Sem desvios, uma chamada recursiva nunca termina
+    std::set<std::string> recursive = recursiveFunctions(module);
+    if (!recursive.empty()) {
+        errorMsg = "a função '" + *recursive.begin() + "' é recursiva e nunca termina";
+        return false;
+    }
+
+    // Valores em XMM0-XMM13; nenhum registrador sobrevive a um CALL (System V)
+    RegAllocOptions regalloc;
+    regalloc.registers = x86::VALUE_REGISTERS;
+    regalloc.convention = "sysv";
+    RegisterAllocator allocator(regalloc);
+    if (!allocator.allocate(module)) {
+        errorMsg = allocator.getError();
+        return false;
+    }
+
+    std::ostringstream out;
+    out << "# Gerado pelo compilador neto";
+    if (!options.sourceName.empty()) out << " a partir de " << options.sourceName;
+    out << "\n    .text\n\n";
+
+    // O objeto não supõe FMA3 no processador que vai executá-lo: FMA, FMS e
+    // FNMA chamam fma da libm
+    ConstantPool pool;
+    TextEmitter emitter(out, pool);
+    for (const auto& func : module.functions) x86::lowerFunction(func, values, false, emitter);
+
+    if (!pool.values.empty()) {
+        out << "    .section .rodata\n    .p2align 3\n";
+        for (size_t k = 0; k < pool.values.size(); k++) {
+            char bits[32];
+            std::snprintf(bits, sizeof(bits), "0x%016llx", static_cast<unsigned long long>(bitsOf(pool.values[k])));
+            out << ".LK" << k << ":\n    .quad   " << bits << "    # " << formatNumber(pool.values[k]) << "\n";
+        }
+        out << "\n";
+    }
+    // Tabela de funções: {const char* name; int arity; int values;} por função
+    if (options.metadata) {
+        out << "    .section .rodata\n";
+        for (size_t i = 0; i < module.functions.size(); i++) {
+            out << ".LN" << i << ":\n    .string \"" << module.functions[i].name << "\"\n";
+        }
+        out << "\n    .section .data.rel.ro,\"aw\"\n    .p2align 3\n"
+            << "    .globl  neto_functions\n    .type   neto_functions, @object\nneto_functions:\n";
+        for (size_t i = 0; i < module.functions.size(); i++) {
+            const IRFunction& func = module.functions[i];
+            out << "    .quad   .LN" << i << "\n    .long   " << func.params.size() << ", " << values[func.name] << "\n";
+        }
+        if (module.functions.empty()) out << "    .zero   16\n";
+        out << "    .size   neto_functions, .-neto_functions\n\n"
+            << "    .section .rodata\n    .p2align 2\n"
+            << "    .globl  neto_function_count\n    .type   neto_function_count, @object\n"
+            << "neto_function_count:\n    .long   " << module.functions.size() << "\n"
+            << "    .size   neto_function_count, 4\n\n";
+    }
+    // Pilha não executável
+    out << "    .section .note.GNU-stack,\"\",@progbits\n";
+
+    source = out.str();
+    return true;
+}
+
+std::string AsmBackend::getError() const {
+    return errorMsg;
+}
+
+std::string systemAssembler() {
+    const char* as = std::getenv("AS");
+    return as && *as ? as : "as";
+}
+
+bool assemble(const std::string& sFile, const std::string& output, bool shared, std::string& error) {
+    std::string object = shared ? output + ".o" : output;
+
+    std::string command = systemAssembler() + " " + shellQuote(sFile) + " -o " + shellQuote(object);
+    if (std::system(command.c_str()) != 0) {
+        error = "o montador falhou (" + command + ")";
+        return false;
+    }
+    if (!shared) return true;
+
+    command = systemCompiler() + " -shared " + shellQuote(object) + " -o " + shellQuote(output) + " -lm";
+    int status = std::system(command.c_str());
+    std::remove(object.c_str());
+    if (status != 0) {
+        error = "a ligação da biblioteca falhou (" + command + ")";
+        return false;
+    }
+    return true;
+}
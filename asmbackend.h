@@ -0,0 +1,44 @@
+#ifndef ASMBACKEND_H
+#define ASMBACKEND_H
+
+#include "codegen.h"
+#include "ir.h"
+#include <string>
+#include <vector>
+
+struct AsmBackendOptions {
+    std::string sourceName;  // Arquivo .neto de origem, citado no cabeçalho do arquivo .s
+    bool metadata;           // --shared: tabela neto_functions (o leiaute de cbackend.h)
+
+    AsmBackendOptions() : metadata(false) {}
+};
+
+// Geração de assembly x86-64 (sintaxe AT&T do GNU as) a partir do código
+// intermediário, sem passar por um compilador C. A tradução é a do JIT
+// (lowering.h), escrita em texto: valores em XMM0-XMM13 (XMM14 e
+// XMM15 são temporários), posições de pilha relativas a RBP e a convenção
+// System V nas chamadas. Cada função neto vira um símbolo global com o mesmo
+// nome e a assinatura double nome(double, ...); funções que retornam vários
+// valores (gradientes) recebem um último parâmetro double* (em RDI, que pode
+// ser NULL), como no código C de cbackend.h. ^, LOG e FMA/FMS/FNMA chamam pow,
+// log e fma da libm pela PLT, e as constantes ficam em .rodata: o objeto pode
+// ir para um executável ou para uma biblioteca compartilhada.
+class AsmBackend {
+private:
+    AsmBackendOptions options;
+    std::string errorMsg;
+
+public:
+    AsmBackend(const AsmBackendOptions& opts = AsmBackendOptions());
+    bool generate(const std::vector<ThreeAddressCode>& code, std::string& source);
+    std::string getError() const;
+};
+
+// Montador do sistema (variável de ambiente AS ou as)
+std::string systemAssembler();
+
+// Monta um arquivo .s em um objeto; com shared, o objeto é ligado em seguida
+// como biblioteca compartilhada pelo compilador C do sistema
+bool assemble(const std::string& sFile, const std::string& output, bool shared, std::string& error);
+
+#endif // ASMBACKEND_H
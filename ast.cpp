@@ -63,3 +63,60 @@ Symbol tokenTypeToSymbol(TokenType type) {
     }
 }
 
+
+std::map<std::string, ASTNode*> functionDeclarations(ASTNode* root) {
+    // FUNC_LIST -> FUNC_DECL*
+    std::map<std::string, ASTNode*> decls;
+    ASTNode* funcList = root && !root->children.empty() ? root->children[0] : nullptr;
+    if (!funcList || funcList->symbol != FUNC_LIST) return decls;
+    for (auto decl : funcList->children) {
+        if (decl->symbol == FUNC_DECL && !decl->children.empty() && decl->children[0]->symbol == T_ID) {
+            decls[decl->children[0]->value] = decl;
+        }
+    }
+    return decls;
+}
+
+std::set<std::string> reachableFunctions(ASTNode* root, const std::vector<std::string>& entries) {
+    std::map<std::string, ASTNode*> decls = functionDeclarations(root);
+    std::set<std::string> reachable;
+    std::vector<std::string> worklist;
+    for (const auto& entry : entries) {
+        if (decls.count(entry) && reachable.insert(entry).second) worklist.push_back(entry);
+    }
+
+    // Percorre apenas o corpo de cada função alcançada (sem recursão: listas
+    // de statements longas geram árvores profundas)
+    while (!worklist.empty()) {
+        ASTNode* decl = decls[worklist.back()];
+        worklist.pop_back();
+
+        std::vector<ASTNode*> stack(1, decl);
+        while (!stack.empty()) {
+            ASTNode* node = stack.back();
+            stack.pop_back();
+
+            if (node->symbol == BASE && node->children.size() > 1 &&
+                node->children[0]->symbol == T_ID && node->children[1]->symbol == ARGS) {
+                const std::string& callee = node->children[0]->value;
+                if (decls.count(callee) && reachable.insert(callee).second) worklist.push_back(callee);
+            }
+            for (auto child : node->children) stack.push_back(child);
+        }
+    }
+
+    return reachable;
+}
+
+size_t countNodes(ASTNode* node) {
+    size_t count = 0;
+    std::vector<ASTNode*> stack;
+    if (node) stack.push_back(node);
+    while (!stack.empty()) {
+        ASTNode* current = stack.back();
+        stack.pop_back();
+        count++;
+        for (auto child : current->children) stack.push_back(child);
+    }
+    return count;
+}
@@ -2,6 +2,8 @@
 #define AST_H
 
 #include "token.h"
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -28,9 +30,17 @@ struct ASTNode {
     
     ASTNode(Symbol s, std::string v = "") : symbol(s), value(v) {}
     
+    // Destruição sem recursão (listas de funções e de statements longas geram
+    // árvores profundas), na mesma ordem da recursão: primeiro filho primeiro
     ~ASTNode() {
-        for (auto child : children) {
-            delete child;
+        std::vector<ASTNode*> stack(children.rbegin(), children.rend());
+        children.clear();
+        while (!stack.empty()) {
+            ASTNode* node = stack.back();
+            stack.pop_back();
+            stack.insert(stack.end(), node->children.rbegin(), node->children.rend());
+            node->children.clear();
+            delete node;
         }
     }
     
@@ -39,5 +49,15 @@ struct ASTNode {
     }
 };
 
+// Declarações de função do programa, por nome
+std::map<std::string, ASTNode*> functionDeclarations(ASTNode* root);
+
+// Funções alcançáveis a partir das entradas seguindo as chamadas (nós BASE
+// com ARGS). Entradas que não foram declaradas não aparecem no resultado.
+std::set<std::string> reachableFunctions(ASTNode* root, const std::vector<std::string>& entries);
+
+// Número de nós da árvore (usado para medir o trabalho evitado)
+size_t countNodes(ASTNode* node);
+
 #endif // AST_H
 
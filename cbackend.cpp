@@ -0,0 +1,295 @@
+#include "cbackend.h"
+#include "ipo.h"
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+// Maior expoente (em valor absoluto) expandido por neto_powi
+const int MAX_INTEGER_POWER = 64;
+
+// Nomes que uma função exportada não pode ter: palavras reservadas do C, as
+// funções da libm usadas pelo código gerado e neto_powi
+const std::set<std::string> RESERVED = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
+    "extern", "float", "for", "goto", "if", "inline", "int", "long", "register", "restrict", "return",
+    "short", "signed", "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void",
+    "volatile", "while", "main", "pow", "log", "sqrt", "fma", "powi"
+};
+
+const char* POWI_HELPER =
+    "/* Potência com expoente inteiro por quadrados sucessivos (-ffast-math) */\n"
+    "static inline double neto_powi(double x, int n) {\n"
+    "    double result = 1.0;\n"
+    "    unsigned m = n < 0 ? -(unsigned)n : (unsigned)n;\n"
+    "    while (m) {\n"
+    "        if (m & 1) result *= x;\n"
+    "        x *= x;\n"
+    "        m >>= 1;\n"
+    "    }\n"
+    "    return n < 0 ? 1.0 / result : result;\n"
+    "}\n\n";
+
+// Literal C de tipo double ("2" seria inteiro: 2 / 3 daria 0)
+std::string cLiteral(double value) {
+    if (std::isnan(value)) return "__builtin_nan(\"\")";
+    if (std::isinf(value)) return value > 0 ? "__builtin_inf()" : "(-__builtin_inf())";
+    std::string text = formatNumber(value);
+    if (text.find_first_of(".e") == std::string::npos) text += ".0";
+    return value < 0 || (value == 0 && std::signbit(value)) ? "(" + text + ")" : text;
+}
+
+// Valores retornados por uma função (o primeiro RETURN é o único executado)
+int returnedValues(const IRFunction& func) {
+    for (const auto& instr : func.body) {
+        if (instr.op == "RETURN") return splitArgs(instr.arg1).size();
+    }
+    return 1;
+}
+
+std::string parameterList(const IRFunction& func, const std::vector<std::string>& names, bool values) {
+    std::string list;
+    for (size_t i = 0; i < func.params.size(); i++) {
+        if (i > 0) list += ", ";
+        list += "double " + names[i];
+    }
+    if (values) list += std::string(func.params.empty() ? "" : ", ") + "double* values";
+    if (list.empty()) list = "void";
+    return list;
+}
+
+} // namespace
+
+CBackend::CBackend(const CBackendOptions& opts) : options(opts) {}
+
+std::string CBackend::function(const IRFunction& func, const std::unordered_map<std::string, int>& values,
+                               bool& usesPowi) {
+    // Locais: "v_" + nome, com o ponto das versões SSA trocado por "_" (e um
+    // sufixo numérico se o nome resultante já estiver em uso)
+    std::unordered_map<std::string, std::string> locals;
+    std::set<std::string> taken;
+    std::vector<std::string> order;
+    auto declare = [&](const std::string& name) {
+        if (locals.count(name)) return;
+        std::string base = "v_" + name;
+        for (auto& c : base) {
+            if (c == '.') c = '_';
+        }
+        std::string local = base;
+        for (int suffix = 1; taken.count(local); suffix++) local = base + "_" + std::to_string(suffix);
+        taken.insert(local);
+        locals[name] = local;
+        order.push_back(name);
+    };
+    for (const auto& param : func.params) declare(param);
+    for (const auto& instr : func.body) {
+        if (!instr.result.empty()) declare(instr.result);
+    }
+
+    auto operand = [&](const std::string& name) -> std::string {
+        if (isNumber(name)) return cLiteral(toNumber(name));
+        auto it = locals.find(name);
+        return it == locals.end() ? "0.0" : it->second;
+    };
+
+    std::vector<std::string> params;
+    for (const auto& param : func.params) params.push_back(locals[param]);
+    std::ostringstream out;
+    out << "static inline double neto_" << func.name << "(" << parameterList(func, params, values.at(func.name) > 1) << ") {\n";
+    size_t declared = 0;
+    for (size_t i = func.params.size(); i < order.size(); i++, declared++) {
+        out << (declared % 8 == 0 ? "    double " : ", ") << locals[order[i]] << " = 0.0";
+        if (declared % 8 == 7 || i + 1 == order.size()) out << ";\n";
+    }
+
+    bool returned = false;
+    for (const auto& instr : func.body) {
+        if (instr.op == "RETURN") {
+            std::vector<std::string> list = splitArgs(instr.arg1);
+            if (list.size() > 1) {
+                out << "    if (values) {\n";
+                for (size_t i = 0; i < list.size(); i++) out << "        values[" << i << "] = " << operand(list[i]) << ";\n";
+                out << "    }\n";
+            }
+            out << "    return " << operand(list[0]) << ";\n";
+            returned = true;
+            break;
+        }
+
+        std::string dst = locals[instr.result];
+        std::string a = operand(instr.arg1), b = operand(instr.arg2), c = operand(instr.arg3);
+        out << "    " << dst << " = ";
+        if (isCopyOp(instr.op)) {
+            out << a;
+        } else if (instr.op == "^") {
+            double exponent = isNumber(instr.arg2) ? toNumber(instr.arg2) : 0.0;
+            bool integer = isNumber(instr.arg2) && exponent == std::floor(exponent) &&
+                           std::fabs(exponent) <= MAX_INTEGER_POWER;
+            if (options.integerPowers && integer) {
+                out << "neto_powi(" << a << ", " << static_cast<int>(exponent) << ")";
+                usesPowi = true;
+            } else {
+                out << "pow(" << a << ", " << b << ")";
+            }
+        } else if (isBinaryOp(instr.op)) {
+            out << a << " " << instr.op << " " << b;
+        } else if (instr.op == "SQRT") {
+            out << "sqrt(" << a << ")";
+        } else if (instr.op == "LOG") {
+            out << "log(" << a << ")";
+        } else if (instr.op == "FMA") {
+            out << "fma(" << a << ", " << b << ", " << c << ")";
+        } else if (instr.op == "FMS") {
+            out << "fma(" << a << ", " << b << ", -" << c << ")";
+        } else if (instr.op == "FNMA") {
+            out << "fma(-" << a << ", " << b << ", " << c << ")";
+        } else if (instr.op == "CALL") {
+            std::vector<std::string> args;
+            for (const auto& arg : splitArgs(instr.arg2)) args.push_back(operand(arg));
+            if (values.at(instr.arg1) > 1) args.push_back("0");
+            out << "neto_" << instr.arg1 << "(" << joinArgs(args) << ")";
+        }
+        out << ";\n";
+    }
+    // Função sem RETURN retorna 0
+    if (!returned) out << "    return 0.0;\n";
+    out << "}\n";
+    return out.str();
+}
+
+bool CBackend::generate(const std::vector<ThreeAddressCode>& code, std::string& source) {
+    errorMsg = "";
+    IRModule module = buildModule(code);
+
+    for (const auto& func : module.functions) {
+        if (RESERVED.count(func.name) || func.name.compare(0, 5, "neto_") == 0) {
+            errorMsg = "a função '" + func.name + "' não pode ser exportada em C (nome reservado)";
+            return false;
+        }
+        for (const auto& instr : func.body) {
+            if (instr.op == "CALL" && !module.find(instr.arg1)) {
+                errorMsg = "função '" + instr.arg1 + "' não existe";
+                return false;
+            }
+        }
+    }
+    // Sem desvios, uma chamada recursiva nunca termina
+    std::set<std::string> recursive = recursiveFunctions(module);
+    if (!recursive.empty()) {
+        errorMsg = "a função '" + *recursive.begin() + "' é recursiva e nunca termina";
+        return false;
+    }
+
+    std::unordered_map<std::string, int> values;
+    for (const auto& func : module.functions) values[func.name] = returnedValues(func);
+
+    std::ostringstream definitions;
+    bool usesPowi = false;
+    for (const auto& func : module.functions) definitions << function(func, values, usesPowi) << "\n";
+
+    std::ostringstream out;
+    out << "/* Gerado pelo compilador neto";
+    if (!options.sourceName.empty()) out << " a partir de " << options.sourceName;
+    out << " */\n";
+    // Sem <math.h>: uma função neto pode ter o nome de outra função da libm
+    out << "double pow(double, double);\ndouble log(double);\ndouble sqrt(double);\n"
+        << "double fma(double, double, double);\n\n";
+    if (usesPowi) out << POWI_HELPER;
+
+    for (const auto& func : module.functions) {
+        std::vector<std::string> params;
+        for (size_t i = 0; i < func.params.size(); i++) params.push_back("a" + std::to_string(i));
+        out << "static inline double neto_" << func.name << "(" << parameterList(func, params, values[func.name] > 1) << ");\n";
+    }
+    out << "\n" << definitions.str();
+
+    out << "/* Funções exportadas */\n";
+    for (const auto& func : module.functions) {
+        std::vector<std::string> params;
+        for (size_t i = 0; i < func.params.size(); i++) params.push_back("a" + std::to_string(i));
+        bool multiple = values[func.name] > 1;
+        std::vector<std::string> forwarded = params;
+        if (multiple) forwarded.push_back("values");
+        out << "double " << func.name << "(" << parameterList(func, params, multiple) << ") {\n"
+            << "    return neto_" << func.name << "(" << joinArgs(forwarded) << ");\n}\n";
+    }
+
+    if (options.metadata) {
+        out << "\n/* Funções da biblioteca: nome, aridade e valores retornados */\n" << NETO_FUNCTION_INFO
+            << "const neto_function_info neto_functions[] = {\n";
+        for (const auto& func : module.functions) {
+            out << "    {\"" << func.name << "\", " << func.params.size() << ", " << values[func.name] << "},\n";
+        }
+        if (module.functions.empty()) out << "    {0, 0, 0}\n";
+        out << "};\nconst int neto_function_count = " << module.functions.size() << ";\n";
+    }
+
+    source = out.str();
+    return true;
+}
+
+std::string CBackend::getError() const {
+    return errorMsg;
+}
+
+std::string sharedHeader(const std::vector<ThreeAddressCode>& code, const std::string& guard,
+                         const std::string& sourceName) {
+    IRModule module = buildModule(code);
+    std::ostringstream out;
+    out << "/* Gerado pelo compilador neto";
+    if (!sourceName.empty()) out << " a partir de " << sourceName;
+    out << " */\n#ifndef " << guard << "\n#define " << guard << "\n\n"
+        << "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n" << NETO_FUNCTION_INFO << "\n"
+        << "extern const neto_function_info neto_functions[];\nextern const int neto_function_count;\n\n";
+
+    for (const auto& func : module.functions) {
+        // Parâmetros com os nomes do arquivo .neto (aN se o nome não servir em C)
+        std::vector<std::string> params;
+        for (size_t i = 0; i < func.params.size(); i++) {
+            const std::string& name = func.params[i];
+            bool valid = !RESERVED.count(name) && name != "values" && name.find('.') == std::string::npos;
+            params.push_back(valid ? name : "a" + std::to_string(i));
+        }
+        int count = returnedValues(func);
+        if (count > 1) {
+            out << "/* values (pode ser NULL): o valor e as " << count - 1 << " derivada(s) parcial(is) */\n";
+        }
+        out << "double " << func.name << "(" << parameterList(func, params, count > 1) << ");\n";
+    }
+
+    out << "\n#ifdef __cplusplus\n}\n#endif\n\n#endif /* " << guard << " */\n";
+    return out.str();
+}
+
+std::string systemCompiler() {
+    const char* cc = std::getenv("CC");
+    return cc && *cc ? cc : "cc";
+}
+
+std::string shellQuote(const std::string& path) {
+    std::string quoted = "'";
+    for (char c : path) quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    return quoted + "'";
+}
+
+bool compileC(const std::string& cFile, const std::string& output, NativeOutput kind, std::string& error,
+              const std::vector<std::string>& objects) {
+    std::string command = systemCompiler() + " -O2 -ffp-contract=off -fno-math-errno";
+    if (kind == NativeOutput::OBJECT) command += " -c";
+    if (kind == NativeOutput::SHARED) command += " -shared -fPIC";
+    command += " " + shellQuote(cFile);
+    for (const auto& object : objects) command += " " + shellQuote(object);
+    command += " -o " + shellQuote(output);
+    if (kind != NativeOutput::OBJECT) command += " -lm";
+    if (kind == NativeOutput::EXECUTABLE) command += " -ldl";
+
+    int status = std::system(command.c_str());
+    if (status != 0) {
+        error = "o compilador C falhou (" + command + ")";
+        return false;
+    }
+    return true;
+}
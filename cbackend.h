@@ -0,0 +1,66 @@
+#ifndef CBACKEND_H
+#define CBACKEND_H
+
+#include "codegen.h"
+#include "ir.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct CBackendOptions {
+    bool integerPowers;      // ^ com expoente inteiro literal vira neto_powi (altera o arredondamento: -ffast-math)
+    std::string sourceName;  // Arquivo .neto de origem, citado no cabeçalho do arquivo C
+    bool metadata;           // --shared: tabela neto_functions com nome, aridade e valores de cada função
+
+    CBackendOptions() : integerPowers(false), metadata(false) {}
+};
+
+// Geração de um arquivo C autocontido a partir do código intermediário:
+// cada função neto vira uma função "static inline double neto_nome(...)"
+// com os temporários e variáveis como locais (inicializados com 0, como nas
+// leituras antes de qualquer atribuição), e uma função exportada "double
+// nome(...)" que a chama. Funções que retornam vários valores (gradientes)
+// recebem um último parâmetro double* que recebe todos eles (pode ser NULL).
+class CBackend {
+private:
+    CBackendOptions options;
+    std::string errorMsg;
+
+    // values: quantos valores cada função retorna
+    std::string function(const IRFunction& func, const std::unordered_map<std::string, int>& values, bool& usesPowi);
+
+public:
+    CBackend(const CBackendOptions& opts = CBackendOptions());
+    bool generate(const std::vector<ThreeAddressCode>& code, std::string& source);
+    std::string getError() const;
+};
+
+// Tabela de funções exportada por uma biblioteca gerada com --shared (os dois
+// geradores usam o mesmo leiaute), para que um programa que a carrega com
+// dlopen descubra as funções sem conhecer o arquivo .neto
+#define NETO_FUNCTION_INFO \
+    "typedef struct {\n" \
+    "    const char* name;   /* Nome da função (símbolo exportado) */\n" \
+    "    int arity;          /* Parâmetros double */\n" \
+    "    int values;         /* Valores retornados: maior que 1 nas funções de gradiente */\n" \
+    "} neto_function_info;\n"
+
+// Cabeçalho C de uma biblioteca gerada com --shared: a tabela de funções e
+// o protótipo de cada função exportada (guard: nome da macro de inclusão)
+std::string sharedHeader(const std::vector<ThreeAddressCode>& code, const std::string& guard,
+                         const std::string& sourceName);
+
+// Compilador C do sistema (variável de ambiente CC ou cc)
+std::string systemCompiler();
+
+// Caminho entre aspas simples para a linha de comando
+std::string shellQuote(const std::string& path);
+
+// Compila um arquivo C com "cc -O2": objeto (.o), biblioteca compartilhada
+// (shared) ou executável (com -ldl), ligado com os objetos dados. Sem contração de
+// a * b + c em FMA, para que os resultados sejam os mesmos do código intermediário.
+enum class NativeOutput { OBJECT, SHARED, EXECUTABLE };
+bool compileC(const std::string& cFile, const std::string& output, NativeOutput kind, std::string& error,
+              const std::vector<std::string>& objects = std::vector<std::string>());
+
+#endif // CBACKEND_H
@@ -1,170 +1,203 @@
 #include "codegen.h"
+#include <algorithm>
 #include <sstream>
 #include <iostream>
 
-CodeGenerator::CodeGenerator() : tempCounter(0), currentFunction("") {}
+CodeGenerator::CodeGenerator() : tempCounter(0), currentFunction(""), sethiUllman(false) {}
 
 std::string CodeGenerator::newTemp() {
     return "t" + std::to_string(tempCounter++);
 }
 
-std::string CodeGenerator::generateExpr(ASTNode* node) {
-    if (!node || node->symbol != EXPR) {
-        return "";
+// Árvore de uma expressão: folhas (op vazio) guardam o operando em value;
+// chamadas têm op "CALL" e o nome da função em value
+struct ExprTree {
+    std::string op;
+    std::string value;
+    std::vector<ExprTree*> children;
+    int need;                // Temporários necessários para avaliar a subárvore
+    
+    ExprTree(const std::string& o, const std::string& v = "") : op(o), value(v), need(0) {}
+    
+    ~ExprTree() {
+        for (auto child : children) {
+            delete child;
+        }
     }
     
+    // Sethi-Ullman generalizado: com os filhos avaliados em ordem decrescente de
+    // necessidade, o i-ésimo é avaliado com i resultados anteriores ainda vivos
+    void computeNeed() {
+        std::vector<int> needs;
+        for (auto child : children) needs.push_back(child->need);
+        std::sort(needs.rbegin(), needs.rend());
+        need = 1;
+        for (size_t i = 0; i < needs.size(); i++) need = std::max(need, needs[i] + static_cast<int>(i));
+    }
+};
+
+namespace {
+
+ExprTree* makeLeaf(const std::string& value) {
+    return new ExprTree("", value);
+}
+
+ExprTree* makeOp(const std::string& op, ExprTree* left, ExprTree* right) {
+    ExprTree* tree = new ExprTree(op);
+    tree->children.push_back(left);
+    tree->children.push_back(right);
+    tree->computeNeed();
+    return tree;
+}
+
+} // namespace
+
+ExprTree* CodeGenerator::buildExpr(ASTNode* node) {
     // EXPR -> TERM EXPR_P
-    if (node->children.size() < 2) return "";
+    if (!node || node->symbol != EXPR || node->children.size() < 2) {
+        return makeLeaf("");
+    }
     
-    ASTNode* term = node->children[0];
     ASTNode* exprP = node->children[1];
-    
-    std::string result = generateTerm(term);
+    ExprTree* result = buildTerm(node->children[0]);
     
     // Processar EXPR_P (pode ter mais operações)
-    while (exprP && exprP->symbol == EXPR_P && exprP->children.size() > 0) {
-        if (exprP->children.size() >= 3) {
-            // Operador encontrado
-            std::string op = "";
-            if (exprP->children[0]->symbol == T_PLUS) op = "+";
-            else if (exprP->children[0]->symbol == T_MINUS) op = "-";
-            
-            if (!op.empty()) {
-                std::string termResult = generateTerm(exprP->children[1]);
-                std::string temp = newTemp();
-                code.push_back(ThreeAddressCode(temp, op, result, termResult));
-                result = temp;
-            }
-            exprP = exprP->children.size() > 2 ? exprP->children[2] : nullptr;
-        } else {
-            break;
+    while (exprP && exprP->symbol == EXPR_P && exprP->children.size() >= 3) {
+        std::string op = "";
+        if (exprP->children[0]->symbol == T_PLUS) op = "+";
+        else if (exprP->children[0]->symbol == T_MINUS) op = "-";
+        
+        if (!op.empty()) {
+            result = makeOp(op, result, buildTerm(exprP->children[1]));
         }
+        exprP = exprP->children[2];
     }
     
     return result;
 }
 
-std::string CodeGenerator::generateTerm(ASTNode* node) {
-    if (!node || node->symbol != TERM) {
-        return "";
+ExprTree* CodeGenerator::buildTerm(ASTNode* node) {
+    // TERM -> FACTOR TERM_P
+    if (!node || node->symbol != TERM || node->children.size() < 2) {
+        return makeLeaf("");
     }
     
-    if (node->children.size() < 2) return "";
-    
-    ASTNode* factor = node->children[0];
     ASTNode* termP = node->children[1];
+    ExprTree* result = buildFactor(node->children[0]);
     
-    std::string result = generateFactor(factor);
-    
-    // Processar TERM_P
-    while (termP && termP->symbol == TERM_P && termP->children.size() > 0) {
-        if (termP->children.size() >= 3) {
-            std::string op = "";
-            if (termP->children[0]->symbol == T_MULT) op = "*";
-            else if (termP->children[0]->symbol == T_DIV) op = "/";
-            
-            if (!op.empty()) {
-                std::string factorResult = generateFactor(termP->children[1]);
-                std::string temp = newTemp();
-                code.push_back(ThreeAddressCode(temp, op, result, factorResult));
-                result = temp;
-            }
-            termP = termP->children.size() > 2 ? termP->children[2] : nullptr;
-        } else {
-            break;
+    while (termP && termP->symbol == TERM_P && termP->children.size() >= 3) {
+        std::string op = "";
+        if (termP->children[0]->symbol == T_MULT) op = "*";
+        else if (termP->children[0]->symbol == T_DIV) op = "/";
+        
+        if (!op.empty()) {
+            result = makeOp(op, result, buildFactor(termP->children[1]));
         }
+        termP = termP->children[2];
     }
     
     return result;
 }
 
-std::string CodeGenerator::generateFactor(ASTNode* node) {
-    if (!node || node->symbol != FACTOR) {
-        return "";
+ExprTree* CodeGenerator::buildFactor(ASTNode* node) {
+    // FACTOR -> BASE FACTOR_P (potência)
+    if (!node || node->symbol != FACTOR || node->children.size() < 2) {
+        return makeLeaf("");
     }
     
-    if (node->children.size() < 2) return "";
-    
-    ASTNode* base = node->children[0];
     ASTNode* factorP = node->children[1];
+    ExprTree* result = buildBase(node->children[0]);
     
-    std::string result = generateBase(base);
-    
-    // Processar FACTOR_P (potência)
-    while (factorP && factorP->symbol == FACTOR_P && factorP->children.size() > 0) {
-        if (factorP->children.size() >= 3 && factorP->children[0]->symbol == T_POW) {
-            std::string baseResult = generateBase(factorP->children[1]);
-            std::string temp = newTemp();
-            code.push_back(ThreeAddressCode(temp, "^", result, baseResult));
-            result = temp;
-            factorP = factorP->children.size() > 2 ? factorP->children[2] : nullptr;
-        } else {
-            break;
-        }
+    while (factorP && factorP->symbol == FACTOR_P && factorP->children.size() >= 3 &&
+           factorP->children[0]->symbol == T_POW) {
+        result = makeOp("^", result, buildBase(factorP->children[1]));
+        factorP = factorP->children[2];
     }
     
     return result;
 }
 
-std::string CodeGenerator::generateBase(ASTNode* node) {
-    if (!node || node->symbol != BASE) {
-        return "";
+ExprTree* CodeGenerator::buildBase(ASTNode* node) {
+    if (!node || node->symbol != BASE || node->children.empty()) {
+        return makeLeaf("");
     }
     
-    if (node->children.empty()) return "";
-    
     ASTNode* firstChild = node->children[0];
     
     // NUM
     if (firstChild->symbol == T_NUM) {
-        return firstChild->value;
+        return makeLeaf(firstChild->value);
     }
     
     // ID (variável)
     if (firstChild->symbol == T_ID) {
-        // Verificar se é chamada de função
+        // Chamada de função: um filho por argumento
         if (node->children.size() > 1 && node->children[1]->symbol == ARGS) {
-            std::string funcName = firstChild->value;
+            ExprTree* call = new ExprTree("CALL", firstChild->value);
             ASTNode* args = node->children[1];
             
-            // Coletar argumentos
-            std::vector<std::string> argList;
             if (!args->children.empty()) {
                 ASTNode* argListNode = args->children[0];
                 while (argListNode && argListNode->symbol == ARG_LIST) {
                     if (!argListNode->children.empty()) {
-                        std::string arg = generateExpr(argListNode->children[0]);
-                        argList.push_back(arg);
-                    }
-                    if (argListNode->children.size() > 1) {
-                        argListNode = argListNode->children[1];
-                    } else {
-                        break;
+                        call->children.push_back(buildExpr(argListNode->children[0]));
                     }
+                    argListNode = argListNode->children.size() > 1 ? argListNode->children[1] : nullptr;
                 }
             }
             
-            // Gerar chamada de função
-            std::string temp = newTemp();
-            std::string argsStr = "";
-            for (size_t i = 0; i < argList.size(); i++) {
-                if (i > 0) argsStr += ", ";
-                argsStr += argList[i];
-            }
-            code.push_back(ThreeAddressCode(temp, "CALL", funcName, argsStr));
-            return temp;
+            call->computeNeed();
+            return call;
         }
         
         // Apenas variável
-        return firstChild->value;
+        return makeLeaf(firstChild->value);
     }
     
     // EXPR entre parênteses
     if (firstChild->symbol == EXPR) {
-        return generateExpr(firstChild);
+        return buildExpr(firstChild);
     }
     
-    return "";
+    return makeLeaf("");
+}
+
+std::string CodeGenerator::emitTree(ExprTree* tree) {
+    if (tree->op.empty()) return tree->value;
+    
+    // Sem reordenação, os operandos são avaliados da esquerda para a direita.
+    // Como as expressões não têm efeitos colaterais, a subárvore mais exigente
+    // pode ser avaliada primeiro sem alterar o resultado.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < tree->children.size(); i++) order.push_back(i);
+    if (sethiUllman) {
+        std::stable_sort(order.begin(), order.end(), [tree](size_t a, size_t b) {
+            return tree->children[a]->need > tree->children[b]->need;
+        });
+    }
+    
+    std::vector<std::string> operands(tree->children.size());
+    for (size_t i : order) operands[i] = emitTree(tree->children[i]);
+    
+    std::string temp = newTemp();
+    if (tree->op == "CALL") {
+        std::string argsStr = "";
+        for (size_t i = 0; i < operands.size(); i++) {
+            if (i > 0) argsStr += ", ";
+            argsStr += operands[i];
+        }
+        code.push_back(ThreeAddressCode(temp, "CALL", tree->value, argsStr));
+    } else {
+        code.push_back(ThreeAddressCode(temp, tree->op, operands[0], operands[1]));
+    }
+    return temp;
+}
+
+std::string CodeGenerator::generateExpr(ASTNode* node) {
+    ExprTree* tree = buildExpr(node);
+    std::string result = emitTree(tree);
+    delete tree;
+    return result;
 }
 
 void CodeGenerator::generateStatement(ASTNode* node) {
@@ -200,8 +233,6 @@ void CodeGenerator::generateStatements(ASTNode* node) {
     for (auto child : node->children) {
         if (child->symbol == STATEMENT) {
             generateStatement(child);
-        } else if (child->symbol == STATEMENTS) {
-            generateStatements(child);
         }
     }
 }
@@ -216,7 +247,25 @@ void CodeGenerator::generateFunction(ASTNode* node) {
     // Primeiro filho é o nome da função
     if (node->children[0]->symbol == T_ID) {
         currentFunction = node->children[0]->value;
-        code.push_back(ThreeAddressCode("", "FUNC", currentFunction));
+        
+        // Parâmetros ficam registrados na própria instrução FUNC
+        std::vector<std::string> params;
+        if (node->children.size() > 1 && !node->children[1]->children.empty()) {
+            ASTNode* paramList = node->children[1]->children[0];
+            while (paramList && paramList->symbol == PARAM_LIST) {
+                if (!paramList->children.empty()) {
+                    params.push_back(paramList->children[0]->value);
+                }
+                paramList = paramList->children.size() > 1 ? paramList->children[1] : nullptr;
+            }
+        }
+        
+        std::string paramsStr = "";
+        for (size_t i = 0; i < params.size(); i++) {
+            if (i > 0) paramsStr += ", ";
+            paramsStr += params[i];
+        }
+        code.push_back(ThreeAddressCode("", "FUNC", currentFunction, paramsStr));
         
         // Gerar statements
         if (node->children.size() > 2) {
@@ -239,14 +288,12 @@ std::vector<ThreeAddressCode> CodeGenerator::generate(ASTNode* root) {
     // PROCESSAR FUNC_LIST
     if (!root->children.empty()) {
         ASTNode* funcList = root->children[0];
-        while (funcList && funcList->symbol == FUNC_LIST) {
-            if (!funcList->children.empty() && funcList->children[0]->symbol == FUNC_DECL) {
-                generateFunction(funcList->children[0]);
-            }
-            if (funcList->children.size() > 1) {
-                funcList = funcList->children[1];
-            } else {
-                break;
+        if (funcList && funcList->symbol == FUNC_LIST) {
+            for (auto decl : funcList->children) {
+                if (decl->symbol != FUNC_DECL) continue;
+                bool skipped = !onlyFunctions.empty() && !decl->children.empty() &&
+                               onlyFunctions.find(decl->children[0]->value) == onlyFunctions.end();
+                if (!skipped) generateFunction(decl);
             }
         }
     }
@@ -254,12 +301,31 @@ std::vector<ThreeAddressCode> CodeGenerator::generate(ASTNode* root) {
     return code;
 }
 
+void CodeGenerator::setSethiUllman(bool enabled) {
+    sethiUllman = enabled;
+}
+
+void CodeGenerator::restrictTo(const std::set<std::string>& names) {
+    onlyFunctions = names;
+}
+
 std::string CodeGenerator::toString() const {
+    return codeToString(code);
+}
+
+std::string codeToString(const std::vector<ThreeAddressCode>& code) {
     std::ostringstream oss;
     
     for (const auto& instr : code) {
         if (instr.op == "FUNC") {
-            oss << "\n=== Funcao: " << instr.arg1 << " ===\n";
+            oss << "\n=== Funcao: " << instr.arg1;
+            // arg3: max-live (número) ou anotação do alocador de registradores
+            if (!instr.arg3.empty() && instr.arg3.find_first_not_of("0123456789") == std::string::npos) {
+                oss << " (max-live: " << instr.arg3 << ")";
+            } else if (!instr.arg3.empty()) {
+                oss << " (" << instr.arg3 << ")";
+            }
+            oss << " ===\n";
         } else if (instr.op == "ENDFUNC") {
             oss << "=== Fim: " << instr.arg1 << " ===\n";
         } else if (instr.op == "RETURN") {
@@ -268,6 +334,8 @@ std::string CodeGenerator::toString() const {
             oss << "  " << instr.result << " = CALL " << instr.arg1 << "(" << instr.arg2 << ")\n";
         } else if (instr.op == "=") {
             oss << "  " << instr.result << " = " << instr.arg1 << "\n";
+        } else if (!instr.arg3.empty()) {
+            oss << "  " << instr.result << " = " << instr.op << " " << instr.arg1 << ", " << instr.arg2 << ", " << instr.arg3 << "\n";
         } else if (!instr.arg2.empty()) {
             oss << "  " << instr.result << " = " << instr.arg1 << " " << instr.op << " " << instr.arg2 << "\n";
         } else {
@@ -2,6 +2,7 @@
 #define CODEGEN_H
 
 #include "ast.h"
+#include <set>
 #include <string>
 #include <vector>
 
@@ -11,23 +12,31 @@ struct ThreeAddressCode {
     std::string op;          // Operador (+, -, *, /, ^, =, CALL, RETURN)
     std::string arg1;        // Primeiro operando
     std::string arg2;        // Segundo operando (pode ser vazio)
+    std::string arg3;        // Terceiro operando (FMA, FMS e FNMA) ou anotação de FUNC
     
     ThreeAddressCode(const std::string& r, const std::string& o, 
-                    const std::string& a1, const std::string& a2 = "")
-        : result(r), op(o), arg1(a1), arg2(a2) {}
+                    const std::string& a1, const std::string& a2 = "",
+                    const std::string& a3 = "")
+        : result(r), op(o), arg1(a1), arg2(a2), arg3(a3) {}
 };
 
+struct ExprTree;
+
 class CodeGenerator {
 private:
     std::vector<ThreeAddressCode> code;
     int tempCounter;
     std::string currentFunction;
+    std::set<std::string> onlyFunctions;   // Vazio: gera todas as funções
+    bool sethiUllman;                      // Ordena a avaliação das subexpressões
     
     std::string newTemp();
+    ExprTree* buildExpr(ASTNode* node);
+    ExprTree* buildTerm(ASTNode* node);
+    ExprTree* buildFactor(ASTNode* node);
+    ExprTree* buildBase(ASTNode* node);
+    std::string emitTree(ExprTree* tree);
     std::string generateExpr(ASTNode* node);
-    std::string generateTerm(ASTNode* node);
-    std::string generateFactor(ASTNode* node);
-    std::string generateBase(ASTNode* node);
     void generateStatement(ASTNode* node);
     void generateStatements(ASTNode* node);
     void generateFunction(ASTNode* node);
@@ -35,8 +44,17 @@ private:
 public:
     CodeGenerator();
     std::vector<ThreeAddressCode> generate(ASTNode* root);
+    void restrictTo(const std::set<std::string>& names);
+    
+    // Avalia primeiro a subexpressão que precisa de mais temporários (números de
+    // Sethi-Ullman, generalizados para os argumentos de chamadas), reduzindo o
+    // máximo de temporários vivos ao mesmo tempo
+    void setSethiUllman(bool enabled);
     std::string toString() const;
 };
 
+// Formata uma lista de instruções no formato textual do arquivo .ir
+std::string codeToString(const std::vector<ThreeAddressCode>& code);
+
 #endif // CODEGEN_H
 
@@ -1,17 +1,34 @@
 #include "compiler.h"
+#include "cbackend.h"
+#include "asmbackend.h"
 #include "parser_interface.h"
 #include "semantic.h"
 #include "codegen.h"
+#include "evaluator.h"
+#include "gradient.h"
+#include "jit.h"
+#include "liveness.h"
 #include "utils.h"
+#include "vm.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <set>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
 
-Compiler::Compiler(bool v) : verbose(v) {}
+Compiler::Compiler(const CompilerOptions& opts) : options(opts), verbose(opts.verbose) {}
 
 bool Compiler::compile(const std::string& source) {
     sourceCode = source;
+    diagnostics.clear();
     
     // Fase 1 e 2: Análise Léxica e Sintática (usando Bison/Flex)
     // O Bison/Flex fazem ambas as análises em conjunto
@@ -21,35 +38,78 @@ bool Compiler::compile(const std::string& source) {
     ASTNode* ast = parse_source(source, parserError);
     
     if (!ast || !parserError.empty()) {
-        std::cout << logError("REJEITADO") << std::endl;
-        if (!parserError.empty()) {
-            std::cout << parserError << std::endl;
-        } else {
-            std::cout << logError("[ERROR] Erro na análise sintática") << std::endl;
-        }
-        return false;
+        return reject("sintática", !parserError.empty() ? parserError : logError("[ERROR] Erro na análise sintática"));
     }
     
     if (verbose) std::cout << logSuccess("[SUCCESS] Árvore sintática construída com sucesso usando parser LR (Bison).") << std::endl << std::endl;
     
+    // Eliminação de funções mortas: só as funções alcançáveis a partir das
+    // entradas (e das funções derivadas) passam pelas fases seguintes
+    std::set<std::string> reachable;
+    std::vector<std::string> entryPoints;
+    if (!options.entries.empty()) {
+        entryPoints = options.entries;
+        entryPoints.insert(entryPoints.end(), options.gradients.begin(), options.gradients.end());
+        reachable = reachableFunctions(ast, entryPoints);
+        
+        for (const auto& entry : entryPoints) {
+            if (reachable.find(entry) == reachable.end()) {
+                delete ast;
+                return reject("semântica", logError("[ERROR] Erro semântico: função de entrada '" + entry + "' não foi declarada"));
+            }
+        }
+        for (const auto& name : options.gradients) entryPoints.push_back(gradientName(name));
+    }
+    
     // Fase 3: Análise Semântica
     if (verbose) std::cout << "=== ANÁLISE SEMÂNTICA ===" << std::endl;
     SemanticAnalyzer semantic;
+    semantic.restrictTo(reachable);
     bool semanticOk = semantic.analyze(ast);
     
     if (!semanticOk) {
-        std::cout << logError("REJEITADO") << std::endl;
-        std::cout << semantic.getError() << std::endl;
         delete ast;
-        return false;
+        return reject("semântica", semantic.getError());
     }
     
-    if (verbose) std::cout << logSuccess("[SUCCESS] Análise semântica concluída com sucesso.") << std::endl << std::endl;
+    if (verbose) std::cout << logSuccess("[SUCCESS] Análise semântica concluída com sucesso.") << std::endl;
+    if (verbose && !reachable.empty()) {
+        size_t total = countNodes(ast);
+        std::cout << "Funções alcançáveis a partir das entradas: " << reachable.size() << " de "
+                  << functionDeclarations(ast).size() << " (" << semantic.getAnalyzedNodes() << " de "
+                  << total << " nós da árvore analisados)" << std::endl;
+    }
+    if (verbose) std::cout << std::endl;
     
     // Fase 4: Geração de Código Intermediário
     if (verbose) std::cout << "=== GERAÇÃO DE CÓDIGO INTERMEDIÁRIO ===" << std::endl;
     CodeGenerator codegen;
-    std::vector<ThreeAddressCode> intermediateCode = codegen.generate(ast);
+    codegen.restrictTo(reachable);
+    codegen.setSethiUllman(options.optimize);
+    intermediateCode = codegen.generate(ast);
+    unoptimizedCode = intermediateCode;
+    
+    // Com -O, as subexpressões são avaliadas em ordem de Sethi-Ullman: compara o
+    // máximo de valores vivos com a ordem da esquerda para a direita
+    if (verbose && options.optimize) {
+        CodeGenerator leftToRight;
+        leftToRight.restrictTo(reachable);
+        IRModule before = buildModule(leftToRight.generate(ast));
+        IRModule after = buildModule(intermediateCode);
+        int liveBefore = 0, liveAfter = 0, peakBefore = 0, peakAfter = 0;
+        for (const auto& func : before.functions) {
+            int live = maxLive(func);
+            liveBefore += live;
+            peakBefore = std::max(peakBefore, live);
+        }
+        for (const auto& func : after.functions) {
+            int live = maxLive(func);
+            liveAfter += live;
+            peakAfter = std::max(peakAfter, live);
+        }
+        std::cout << "Ordem de avaliação (Sethi-Ullman): max-live " << liveBefore << " -> " << liveAfter
+                  << " (soma por função), " << peakBefore << " -> " << peakAfter << " (maior função)" << std::endl;
+    }
     
     if (verbose) {
         std::cout << logSuccess("[SUCCESS] Código intermediário gerado com sucesso.") << std::endl;
@@ -58,12 +118,92 @@ bool Compiler::compile(const std::string& source) {
         std::cout << "--- Fim do Código Intermediário ---\n\n";
     }
     
-    std::cout << logSuccess("[SUCCESS] Compilação concluída com sucesso.") << std::endl;
+    // Geração das funções de gradiente (antes da otimização, que também as processa)
+    if (!options.gradients.empty()) {
+        if (verbose) std::cout << "=== DIFERENCIAÇÃO AUTOMÁTICA ===" << std::endl;
+        IRModule module = buildModule(intermediateCode);
+        
+        for (const auto& name : options.gradients) {
+            std::string gradError;
+            if (!generateGradient(module, name, gradError)) {
+                delete ast;
+                return reject("diferenciação", logError("[ERROR] Erro na diferenciação: " + gradError));
+            }
+        }
+        
+        intermediateCode = flattenModule(module);
+        unoptimizedCode = intermediateCode;
+        
+        if (verbose) {
+            IRModule gradients;
+            for (const auto& name : options.gradients) gradients.functions.push_back(*module.find(gradientName(name)));
+            std::cout << logSuccess("[SUCCESS] Funções de gradiente geradas (modo reverso).") << std::endl;
+            std::cout << codeToString(flattenModule(gradients)) << std::endl;
+        }
+    }
+    
+    // Fase 5 (opcional): Otimização do Código Intermediário
+    if (options.optimize) {
+        if (verbose) std::cout << "=== OTIMIZAÇÃO ===" << std::endl;
+        OptimizerOptions optimizerOptions = options.optimizer;
+        optimizerOptions.entryPoints = entryPoints;
+        Optimizer optimizer(optimizerOptions);
+        intermediateCode = optimizer.optimize(intermediateCode);
+        
+        if (verbose) {
+            std::cout << optimizer.report();
+            std::cout << "\n--- Código Otimizado ---\n";
+            std::cout << codeToString(intermediateCode);
+            std::cout << "--- Fim do Código Otimizado ---\n\n";
+        }
+    }
+    
+    // Fase 6 (opcional): Alocação de Registradores
+    if (options.emit == "regs") {
+        if (verbose) std::cout << "=== ALOCAÇÃO DE REGISTRADORES ===" << std::endl;
+        IRModule module = buildModule(intermediateCode);
+        RegisterAllocator allocator(options.regalloc);
+        
+        if (!allocator.allocate(module)) {
+            delete ast;
+            return reject("alocação", logError("[ERROR] Erro na alocação de registradores: " + allocator.getError()));
+        }
+        intermediateCode = flattenModule(module);
+        
+        if (verbose) {
+            std::cout << allocator.report();
+            std::cout << "\n--- Código com Registradores ---\n";
+            std::cout << codeToString(intermediateCode);
+            std::cout << "--- Fim do Código com Registradores ---\n\n";
+        }
+    }
+    
+    if (!options.quiet) std::cout << logSuccess("[SUCCESS] Compilação concluída com sucesso.") << std::endl;
     
     delete ast;
     return true;
 }
 
+bool Compiler::reject(const std::string& phase, const std::string& message) {
+    Diagnostic diagnostic;
+    diagnostic.phase = phase;
+    diagnostic.message = plainMessage(message);
+    if (diagnostic.message.compare(0, 8, "[ERROR] ") == 0) diagnostic.message = diagnostic.message.substr(8);
+    
+    // Erros do parser: "... na linha L, coluna C"
+    size_t at = diagnostic.message.rfind(" na linha ");
+    if (at != std::string::npos) {
+        std::sscanf(diagnostic.message.c_str() + at, " na linha %d, coluna %d", &diagnostic.line, &diagnostic.column);
+    }
+    diagnostics.push_back(diagnostic);
+    
+    if (!options.quiet) {
+        std::cout << logError("REJEITADO") << std::endl;
+        std::cout << message << std::endl;
+    }
+    return false;
+}
+
 bool Compiler::compileFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -80,36 +220,513 @@ bool Compiler::compileFile(const std::string& filename) {
     
     // Se compilação foi bem-sucedida, salvar código intermediário em arquivo
     if (result) {
-        // Gerar código intermediário novamente para salvar
-        std::string parserError;
-        ASTNode* ast = parse_source(sourceCode, parserError);
-        if (ast) {
-            CodeGenerator codegen;
-            codegen.generate(ast);
-            
-            // Criar nome do arquivo de saída: nome.ir
-            std::string outputFile = filename;
-            size_t pos = outputFile.find_last_of('.');
-            if (pos != std::string::npos) {
-                outputFile = outputFile.substr(0, pos) + ".ir";
-            } else {
-                outputFile += ".ir";
+        // Criar nome do arquivo de saída: nome.ir
+        std::string outputFile = filename;
+        size_t pos = outputFile.find_last_of('.');
+        if (pos != std::string::npos) {
+            outputFile = outputFile.substr(0, pos) + ".ir";
+        } else {
+            outputFile += ".ir";
+        }
+        
+        // Salvar em arquivo
+        std::ofstream outFile(outputFile);
+        if (outFile.is_open()) {
+            outFile << codeToString(intermediateCode);
+            outFile.close();
+            if (verbose) {
+                std::cout << logSuccess("[INFO] Código intermediário salvo em: " + outputFile) << std::endl;
+            }
+        }
+    }
+    
+    if (result && (options.emit == "c" || options.emit == "asm" || options.native)) {
+        result = emitNative(filename);
+    }
+    
+    return result;
+}
+
+bool Compiler::emitNative(const std::string& filename) {
+    // --emit=asm: assembly x86-64; --emit=c (ou apenas --native): C
+    bool assembly = options.emit == "asm";
+    std::string source, error;
+    if (assembly) {
+        AsmBackendOptions backendOptions;
+        backendOptions.sourceName = filename;
+        backendOptions.metadata = options.shared;
+        AsmBackend backend(backendOptions);
+        if (!backend.generate(intermediateCode, source)) error = backend.getError();
+    } else {
+        CBackendOptions backendOptions;
+        backendOptions.integerPowers = options.optimizer.fastMath;
+        backendOptions.sourceName = filename;
+        backendOptions.metadata = options.shared;
+        CBackend backend(backendOptions);
+        if (!backend.generate(intermediateCode, source)) error = backend.getError();
+    }
+    if (!error.empty()) {
+        std::cout << logError(std::string("[ERROR] Erro na geração de ") + (assembly ? "assembly" : "C") + ": " + error) << std::endl;
+        return false;
+    }
+    
+    // nome.c ou nome.s e, com --native, nome.o (ou o arquivo de -o)
+    size_t pos = filename.find_last_of('.');
+    std::string base = pos != std::string::npos ? filename.substr(0, pos) : filename;
+    std::string sourceFile = base + (assembly ? ".s" : ".c");
+    std::ofstream outFile(sourceFile);
+    if (!outFile.is_open()) {
+        std::cout << logError("[ERROR] Não foi possível criar o arquivo '" + sourceFile + "'") << std::endl;
+        return false;
+    }
+    outFile << source;
+    outFile.close();
+    if (verbose || !options.native) {
+        std::cout << logSuccess(std::string("[INFO] ") + (assembly ? "Assembly" : "Código C") + " salvo em: " + sourceFile) << std::endl;
+    }
+    if (!options.native) return true;
+    
+    std::string output = options.output.empty() ? base + (options.shared ? ".so" : ".o") : options.output;
+    bool shared = options.shared || (output.size() > 3 && output.compare(output.size() - 3, 3, ".so") == 0);
+    bool ok = assembly ? assemble(sourceFile, output, shared, error)
+                       : compileC(sourceFile, output, shared ? NativeOutput::SHARED : NativeOutput::OBJECT, error);
+    if (!ok) {
+        std::cout << logError("[ERROR] " + error) << std::endl;
+        return false;
+    }
+    std::cout << logSuccess("[SUCCESS] Código nativo gerado: " + output) << std::endl;
+    if (!options.shared) return true;
+    
+    // --shared: libformulas.so -> libformulas.h, com a macro LIBFORMULAS_H
+    size_t slash = output.find_last_of('/');
+    size_t dot = output.find_last_of('.');
+    std::string stem = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? output.substr(0, dot) : output;
+    std::string headerFile = stem + ".h";
+    std::string guard;
+    for (char c : stem.substr(slash == std::string::npos ? 0 : slash + 1)) {
+        guard += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    if (guard.empty() || std::isdigit(static_cast<unsigned char>(guard[0]))) guard = "NETO_" + guard;
+    std::ofstream header(headerFile);
+    if (!header.is_open()) {
+        std::cout << logError("[ERROR] Não foi possível criar o arquivo '" + headerFile + "'") << std::endl;
+        return false;
+    }
+    header << sharedHeader(intermediateCode, guard + "_H", filename);
+    header.close();
+    std::cout << logSuccess("[SUCCESS] Cabeçalho gerado: " + headerFile) << std::endl;
+    
+    char* path = realpath(output.c_str(), nullptr);
+    sharedLibrary = path ? path : output;
+    std::free(path);
+    return true;
+}
+
+namespace {
+
+// Executa a função repetidamente e mostra chamadas, instruções e tempo por execução
+void benchmarkEvaluator(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                        const std::vector<double>& args, int iterations, const std::string& label) {
+    Evaluator evaluator(code);
+    double result = 0.0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        if (!evaluator.call(function, args, result)) return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::cout << "[Avaliador] " << label << ": "
+              << evaluator.getCalls() / iterations << " chamada(s), "
+              << evaluator.getSteps() / iterations << " instrução(ões), "
+              << formatNumber(static_cast<long>(ns * 10) / 10.0) << " ns por execução" << std::endl;
+}
+
+// Nome do modo de despacho da máquina virtual nas medições
+std::string dispatchName(const VMOptions& vmOptions) {
+    std::string name = vmOptions.threaded ? "goto computado" : "switch";
+    if (vmOptions.superinstructions) name += " + superinstruções";
+    return name;
+}
+
+// Mesma medição na máquina virtual: chamadas por segundo e custo por instrução de bytecode
+void benchmarkVM(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                 const std::vector<double>& args, int iterations, const std::string& label,
+                 const VMOptions& vmOptions, bool verbose) {
+    VM vm(code, vmOptions);
+    int index = vm.function(function);
+    double result = 0.0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        if (!vm.call(index, args.data(), result)) return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    
+    double totalNs = std::chrono::duration<double, std::nano>(end - start).count();
+    double ns = totalNs / iterations;
+    double perInstruction = vm.getInstructions() > 0 ? totalNs / vm.getInstructions() : 0.0;
+    long callsPerSecond = static_cast<long>(vm.getCalls() / (totalNs / 1e9));
+    std::cout << "[VM] " << label << ", " << dispatchName(vmOptions) << ": "
+              << vm.getCalls() / iterations << " chamada(s), "
+              << vm.getInstructions() / iterations << " instrução(ões), "
+              << formatNumber(static_cast<long>(ns * 10) / 10.0) << " ns por execução, "
+              << callsPerSecond << " chamadas/s, "
+              << formatNumber(static_cast<long>(perInstruction * 100) / 100.0) << " ns por instrução" << std::endl;
+    if (verbose && vmOptions.superinstructions) {
+        std::string report = vm.fusionReport();
+        std::cout << "[VM] Superinstruções: " << (report.empty() ? "nenhuma" : report) << std::endl;
+    }
+}
+
+// Medição A/B: switch simples (sem superinstruções) e o modo configurado
+void benchmarkDispatch(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                       const std::vector<double>& args, int iterations, const std::string& label,
+                       const VMOptions& vmOptions, bool verbose) {
+    VMOptions baseline;
+    baseline.threaded = false;
+    baseline.superinstructions = false;
+    benchmarkVM(code, function, args, iterations, label, baseline, verbose);
+    if (vmOptions.threaded || vmOptions.superinstructions) {
+        benchmarkVM(code, function, args, iterations, label, vmOptions, verbose);
+    }
+}
+
+// Mesma medição com o código nativo do JIT (a tradução fica fora do tempo medido)
+void benchmarkJIT(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                  const std::vector<double>& args, int iterations, const std::string& label) {
+    auto start = std::chrono::steady_clock::now();
+    JIT jit(code);
+    auto end = std::chrono::steady_clock::now();
+    double compileUs = std::chrono::duration<double, std::micro>(end - start).count();
+    JIT::EntryPoint entry = jit.entry(jit.function(function));
+    if (!entry) return;
+    
+    volatile double sink = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) sink = entry(args.data());
+    end = std::chrono::steady_clock::now();
+    (void)sink;
+    
+    double totalNs = std::chrono::duration<double, std::nano>(end - start).count();
+    double ns = totalNs / iterations;
+    long callsPerSecond = static_cast<long>(iterations / (totalNs / 1e9));
+    
+    // Latência: o primeiro argumento depende do resultado anterior (r * 0),
+    // e as execuções não podem ser sobrepostas pelo processador. É aqui que
+    // aparece o caminho crítico (a reassociação de -ffast-math, por exemplo)
+    std::string latency;
+    if (!args.empty()) {
+        std::vector<double> chained(args);
+        double result = 0.0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            chained[0] = args[0] + result * 0.0;
+            result = entry(chained.data());
+        }
+        end = std::chrono::steady_clock::now();
+        sink = result;
+        double latencyNs = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        latency = formatNumber(static_cast<long>(latencyNs * 10) / 10.0) + " ns de latência, ";
+    }
+    std::cout << "[JIT] " << label << ": "
+              << formatNumber(static_cast<long>(ns * 10) / 10.0) << " ns por execução, "
+              << callsPerSecond << " execuções/s, " << latency
+              << jit.codeSize() << " bytes de código, "
+              << formatNumber(static_cast<long>(compileUs * 10) / 10.0) << " us de tradução" << std::endl;
+}
+
+// Programa de medição: chama a função iterations vezes com argumentos
+// voláteis e imprime os ns por execução
+std::string benchmarkHarness(const std::string& callee, const std::vector<double>& args, bool multiple, int iterations,
+                             const std::string& setup = "") {
+    std::ostringstream harness;
+    harness << "\n#include <stdio.h>\n#include <time.h>\n\nint main(void) {\n" << setup;
+    harness << "    volatile double args[" << std::max<size_t>(args.size(), 1) << "] = {";
+    for (size_t i = 0; i < args.size(); i++) harness << (i > 0 ? ", " : "") << formatNumber(args[i]);
+    if (args.empty()) harness << "0";
+    harness << "};\n    volatile double sink = 0.0;\n    struct timespec start, end;\n"
+            << "    clock_gettime(CLOCK_MONOTONIC, &start);\n"
+            << "    for (long i = 0; i < " << iterations << "L; i++) sink = " << callee << "(";
+    for (size_t i = 0; i < args.size(); i++) harness << (i > 0 ? ", " : "") << "args[" << i << "]";
+    if (multiple) harness << (args.empty() ? "0" : ", 0");
+    harness << ");\n    clock_gettime(CLOCK_MONOTONIC, &end);\n"
+            << "    double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);\n"
+            << "    printf(\"%.3f\\n\", ns / " << iterations << ");\n    return 0;\n}\n";
+    return harness.str();
+}
+
+// Compila (com o assembly, se houver) e executa o programa de medição em um
+// diretório temporário; -1 se algum passo falhar
+double runHarness(const std::string& cSource, const std::string& assembly) {
+    char directory[] = "/tmp/netoXXXXXX";
+    if (!mkdtemp(directory)) return -1.0;
+    std::string cFile = std::string(directory) + "/bench.c";
+    std::string sFile = std::string(directory) + "/bench.s";
+    std::string object = std::string(directory) + "/bench.o";
+    std::string program = std::string(directory) + "/bench";
+    std::ofstream(cFile) << cSource;
+    
+    std::string error;
+    std::vector<std::string> objects;
+    bool ok = true;
+    if (!assembly.empty()) {
+        std::ofstream(sFile) << assembly;
+        ok = assemble(sFile, object, false, error);
+        objects.push_back(object);
+    }
+    double ns = -1.0;
+    if (ok && compileC(cFile, program, NativeOutput::EXECUTABLE, error, objects)) {
+        FILE* pipe = popen(program.c_str(), "r");
+        if (pipe) {
+            if (std::fscanf(pipe, "%lf", &ns) != 1) ns = -1.0;
+            pclose(pipe);
+        }
+    }
+    for (const auto& file : {cFile, sFile, object, program}) std::remove(file.c_str());
+    rmdir(directory);
+    return ns;
+}
+
+bool returnsMultiple(const std::vector<ThreeAddressCode>& code, const std::string& function) {
+    IRModule module = buildModule(code);
+    const IRFunction* func = module.find(function);
+    if (!func) return false;
+    for (const auto& instr : func->body) {
+        if (instr.op == "RETURN") return splitArgs(instr.arg1).size() > 1;
+    }
+    return false;
+}
+
+void printNative(const std::string& tag, const std::string& label, double ns, const std::string& tool) {
+    if (ns < 0) return;
+    long callsPerSecond = ns > 0 ? static_cast<long>(1e9 / ns) : 0;
+    std::cout << "[" << tag << "] " << label << ": "
+              << formatNumber(static_cast<long>(ns * 10) / 10.0) << " ns por execução, "
+              << callsPerSecond << " execuções/s (" << tool << ")" << std::endl;
+}
+
+// Mesma medição com o código C gerado: o programa de medição é compilado
+// junto com ele (as funções static inline podem ser expandidas no laço, como
+// em um programa que inclui o código gerado)
+void benchmarkC(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                const std::vector<double>& args, int iterations, const std::string& label, bool fastMath) {
+    CBackendOptions backendOptions;
+    backendOptions.integerPowers = fastMath;
+    CBackend backend(backendOptions);
+    std::string source;
+    if (!backend.generate(code, source)) return;
+    
+    bool multiple = returnsMultiple(code, function);
+    double ns = runHarness(source + benchmarkHarness("neto_" + function, args, multiple, iterations), "");
+    printNative("C", label, ns, systemCompiler() + " -O2");
+}
+
+// ... e com o assembly gerado: o objeto montado é ligado ao programa de
+// medição, que chama o símbolo exportado
+void benchmarkAsm(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                  const std::vector<double>& args, int iterations, const std::string& label) {
+    AsmBackend backend;
+    std::string assembly;
+    if (!backend.generate(code, assembly)) return;
+    
+    bool multiple = returnsMultiple(code, function);
+    std::string declaration = "double " + function + "(";
+    for (size_t i = 0; i < args.size(); i++) declaration += i > 0 ? ", double" : "double";
+    if (multiple) declaration += args.empty() ? "double*" : ", double*";
+    if (args.empty() && !multiple) declaration += "void";
+    declaration += ");\n";
+    double ns = runHarness(declaration + benchmarkHarness(function, args, multiple, iterations), assembly);
+    printNative("ASM", label, ns, systemAssembler());
+}
+
+// ... e com a biblioteca de --shared, como um programa hospedeiro a usaria:
+// dlopen, dlsym e chamadas pelo ponteiro (sem expansão no laço)
+void benchmarkShared(const std::string& library, const std::string& function, const std::vector<double>& args,
+                     bool multiple, int iterations) {
+    std::string params;
+    for (size_t i = 0; i < args.size(); i++) params += i > 0 ? ", double" : "double";
+    if (multiple) params += args.empty() ? "double*" : ", double*";
+    if (params.empty()) params = "void";
+    std::string setup =
+        "    void* library = dlopen(\"" + library + "\", RTLD_NOW);\n"
+        "    if (!library) return 1;\n"
+        "    typedef double (*function_t)(" + params + ");\n"
+        "    function_t volatile function = (function_t) dlsym(library, \"" + function + "\");\n"
+        "    if (!function) return 1;\n";
+    double ns = runHarness("#include <dlfcn.h>\n" + benchmarkHarness("function", args, multiple, iterations, setup), "");
+    printNative("SO", library, ns, "dlsym");
+}
+
+// Compara f__grad com diferenças finitas centrais sobre f: 2N + 1 execuções de f
+// por gradiente, com passo proporcional a cada argumento
+void compareFiniteDifferences(const std::vector<ThreeAddressCode>& code, const std::string& function,
+                              const std::vector<double>& args, const std::vector<double>& gradient,
+                              int iterations) {
+    Evaluator evaluator(code);
+    std::vector<double> results;
+    std::vector<double> differences(args.size());
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        if (!evaluator.call(gradientName(function), args, results)) return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double reverseNs = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        double value, forward, backward;
+        if (!evaluator.call(function, args, value)) return;
+        for (size_t j = 0; j < args.size(); j++) {
+            std::vector<double> shifted = args;
+            double step = 6e-6 * std::max(1.0, std::fabs(args[j]));
+            shifted[j] = args[j] + step;
+            evaluator.call(function, shifted, forward);
+            shifted[j] = args[j] - step;
+            evaluator.call(function, shifted, backward);
+            differences[j] = (forward - backward) / (2 * step);
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    double finiteNs = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    
+    double maxError = 0.0;
+    for (size_t j = 0; j < args.size() && j + 1 < gradient.size(); j++) {
+        maxError = std::max(maxError, std::fabs(differences[j] - gradient[j + 1]));
+    }
+    
+    std::cout << "[Gradiente] modo reverso: 1 chamada, "
+              << formatNumber(static_cast<long>(reverseNs * 10) / 10.0) << " ns por gradiente" << std::endl;
+    std::cout << "[Gradiente] diferenças finitas: " << 2 * args.size() + 1 << " chamada(s), "
+              << formatNumber(static_cast<long>(finiteNs * 10) / 10.0) << " ns por gradiente, "
+              << "diferença máxima " << formatNumber(maxError) << std::endl;
+}
+
+} // namespace
+
+bool Compiler::run(const std::string& function, const std::vector<double>& args) {
+    std::vector<double> results;
+    if (options.jit) {
+        JIT jit(intermediateCode);
+        if (!jit.call(function, args, results)) {
+            std::cout << logError("[ERROR] Erro de execução: " + jit.getError()) << std::endl;
+            return false;
+        }
+    } else {
+        VM vm(intermediateCode, options.vm);
+        if (!vm.call(function, args, results)) {
+            std::cout << logError("[ERROR] Erro de execução: " + vm.getError()) << std::endl;
+            return false;
+        }
+    }
+    
+    std::string argsStr = "";
+    for (size_t i = 0; i < args.size(); i++) {
+        if (i > 0) argsStr += ", ";
+        argsStr += formatNumber(args[i]);
+    }
+    std::string resultStr = "";
+    for (size_t i = 0; i < results.size(); i++) {
+        if (i > 0) resultStr += ", ";
+        resultStr += formatNumber(results[i]);
+    }
+    std::cout << function << "(" << argsStr << ") = " << resultStr << std::endl;
+    
+    if (verbose || options.benchIterations > 0) {
+        int iterations = options.benchIterations > 0 ? options.benchIterations : 1;
+        if (options.optimize) {
+            benchmarkEvaluator(unoptimizedCode, function, args, iterations, "sem otimização");
+            benchmarkEvaluator(intermediateCode, function, args, iterations, "otimizado");
+            benchmarkDispatch(unoptimizedCode, function, args, iterations, "sem otimização", options.vm, verbose);
+            benchmarkDispatch(intermediateCode, function, args, iterations, "otimizado", options.vm, verbose);
+            if (options.jit) {
+                benchmarkJIT(unoptimizedCode, function, args, iterations, "sem otimização");
+                benchmarkJIT(intermediateCode, function, args, iterations, "otimizado");
+            }
+            if (options.native || options.emit == "c" || options.emit == "asm") {
+                benchmarkC(unoptimizedCode, function, args, iterations, "sem otimização", options.optimizer.fastMath);
+                benchmarkC(intermediateCode, function, args, iterations, "otimizado", options.optimizer.fastMath);
+            }
+            if (options.emit == "asm") {
+                benchmarkAsm(unoptimizedCode, function, args, iterations, "sem otimização");
+                benchmarkAsm(intermediateCode, function, args, iterations, "otimizado");
+            }
+        } else {
+            benchmarkEvaluator(intermediateCode, function, args, iterations, "sem otimização");
+            benchmarkDispatch(intermediateCode, function, args, iterations, "sem otimização", options.vm, verbose);
+            if (options.jit) benchmarkJIT(intermediateCode, function, args, iterations, "sem otimização");
+            if (options.native || options.emit == "c" || options.emit == "asm") {
+                benchmarkC(intermediateCode, function, args, iterations, "sem otimização", options.optimizer.fastMath);
+            }
+            if (options.emit == "asm") benchmarkAsm(intermediateCode, function, args, iterations, "sem otimização");
+        }
+        
+        if (!sharedLibrary.empty()) {
+            benchmarkShared(sharedLibrary, function, args, returnsMultiple(intermediateCode, function), iterations);
+        }
+        
+        // Funções de gradiente: comparação com diferenças finitas sobre a função original
+        for (const auto& name : options.gradients) {
+            if (function == gradientName(name)) {
+                compareFiniteDifferences(intermediateCode, name, args, results, iterations);
+            }
+        }
+    }
+    
+    return true;
+}
+
+bool Compiler::checkJIT() {
+    IRModule module = buildModule(intermediateCode);
+    VM vm(module, options.vm);
+    JIT jit(module);
+    
+    // Três conjuntos de argumentos por função: pequenos, negativos e grandes
+    int compared = 0, differences = 0;
+    for (const auto& func : module.functions) {
+        for (int set = 0; set < 3; set++) {
+            std::vector<double> args;
+            for (size_t i = 0; i < func.params.size(); i++) {
+                if (set == 0) args.push_back(0.5 + 0.75 * i);
+                else if (set == 1) args.push_back(3.0 - 1.25 * i);
+                else args.push_back(1000.0 / (i + 1));
             }
             
-            // Salvar em arquivo
-            std::ofstream outFile(outputFile);
-            if (outFile.is_open()) {
-                outFile << codegen.toString();
-                outFile.close();
-                if (verbose) {
-                    std::cout << logSuccess("[INFO] Código intermediário salvo em: " + outputFile) << std::endl;
-                }
+            std::vector<double> expected, actual;
+            bool vmOk = vm.call(func.name, args, expected);
+            bool jitOk = jit.call(func.name, args, actual);
+            bool same = vmOk == jitOk && expected.size() == actual.size();
+            for (size_t i = 0; same && i < expected.size(); i++) {
+                same = std::memcmp(&expected[i], &actual[i], sizeof(double)) == 0 ||
+                       (std::isnan(expected[i]) && std::isnan(actual[i]));
             }
+            compared++;
+            if (same) continue;
             
-            delete ast;
+            differences++;
+            std::string argsStr = "";
+            for (size_t i = 0; i < args.size(); i++) {
+                if (i > 0) argsStr += ", ";
+                argsStr += formatNumber(args[i]);
+            }
+            std::string vmStr = vmOk ? formatNumber(expected[0]) : vm.getError();
+            std::string jitStr = jitOk ? formatNumber(actual[0]) : jit.getError();
+            std::cout << logError("[JIT] " + func.name + "(" + argsStr + "): VM " + vmStr + ", JIT " + jitStr) << std::endl;
         }
     }
     
-    return result;
+    std::cout << "[JIT] " << compared << " execução(ões) comparada(s) com a máquina virtual, "
+              << differences << " diferença(s), " << jit.codeSize() << " bytes de código" << std::endl;
+    return differences == 0;
+}
+
+const std::vector<ThreeAddressCode>& Compiler::getCode() const {
+    return intermediateCode;
+}
+
+const std::vector<Diagnostic>& Compiler::getDiagnostics() const {
+    return diagnostics;
 }
 
@@ -1,18 +1,67 @@
 #ifndef COMPILER_H
 #define COMPILER_H
 
+#include "codegen.h"
+#include "optimizer.h"
+#include "regalloc.h"
+#include "vm.h"
 #include <string>
+#include <vector>
+
+// Erro de compilação como dado: a mensagem impressa após "[ERROR] ", sem cores
+struct Diagnostic {
+    std::string phase;           // "sintática", "semântica", "diferenciação" ou "alocação"
+    std::string message;
+    int line;                    // Posição no código-fonte (0 se a mensagem não tem)
+    int column;
+
+    Diagnostic() : line(0), column(0) {}
+};
+
+struct CompilerOptions {
+    bool verbose;
+    bool optimize;               // -O: executa o otimizador sobre o código intermediário
+    OptimizerOptions optimizer;
+    int benchIterations;         // --bench N: repete a execução de --run N vezes
+    std::vector<std::string> gradients;  // --grad=f,g: gera f__grad e g__grad
+    std::vector<std::string> entries;    // --entry=f,g: apenas funções alcançáveis a partir destas
+    std::string emit;            // --emit=regs: código com registradores físicos; --emit=c|asm: arquivo C ou assembly
+    RegAllocOptions regalloc;
+    VMOptions vm;                // --dispatch=switch|threaded, --no-superinstructions
+    bool jit;                    // --jit: --run executa o código nativo gerado pelo JIT
+    bool native;                 // --native: compila o arquivo C (cc) ou monta o assembly (as) gerado
+    std::string output;          // -o: arquivo gerado por --native (.o ou, terminado em .so, biblioteca)
+    bool shared;                 // --shared: biblioteca compartilhada com cabeçalho e tabela de funções
+    bool quiet;                  // Nada é impresso: erros apenas em getDiagnostics (libneto)
+    
+    CompilerOptions()
+        : verbose(false), optimize(false), benchIterations(0), jit(false), native(false), shared(false), quiet(false) {}
+};
 
 class Compiler {
 private:
     std::string sourceCode;
+    CompilerOptions options;
     bool verbose;
+    std::vector<ThreeAddressCode> intermediateCode;
+    std::vector<ThreeAddressCode> unoptimizedCode;
+    std::string sharedLibrary;   // Biblioteca gerada com --shared (medida em --bench)
+    std::vector<Diagnostic> diagnostics;
+    
+    // Registra o erro e, fora do modo silencioso, imprime REJEITADO e a mensagem
+    bool reject(const std::string& phase, const std::string& message);
+    // --emit=c|asm e --native: arquivo C ou .s ao lado do .neto e, com --native, o objeto
+    bool emitNative(const std::string& filename);
     
 public:
-    Compiler(bool v = false);
+    Compiler(const CompilerOptions& opts = CompilerOptions());
     bool compile(const std::string& source);
     bool compileFile(const std::string& filename);
+    bool run(const std::string& function, const std::vector<double>& args);
+    // Executa cada função na máquina virtual e no JIT e compara os resultados bit a bit
+    bool checkJIT();
+    const std::vector<ThreeAddressCode>& getCode() const;
+    const std::vector<Diagnostic>& getDiagnostics() const;
 };
 
 #endif // COMPILER_H
-
@@ -0,0 +1,515 @@
+#include "egraph.h"
+#include <chrono>
+#include <cmath>
+#include <set>
+#include <utility>
+
+// ==================== E-GRAPH ====================
+
+EGraph::EGraph() : nodeCount(0) {}
+
+int EGraph::find(int id) {
+    while (parent[id] != id) {
+        parent[id] = parent[parent[id]];
+        id = parent[id];
+    }
+    return id;
+}
+
+std::string EGraph::key(const ENode& node) {
+    std::string result = node.op + "(" + node.value;
+    for (int child : node.children) result += "," + std::to_string(find(child));
+    return result + ")";
+}
+
+int EGraph::add(const ENode& node) {
+    ENode canonical = node;
+    for (auto& child : canonical.children) child = find(child);
+
+    std::string k = key(canonical);
+    auto it = memo.find(k);
+    if (it != memo.end()) return find(it->second);
+
+    int id = classes.size();
+    parent.push_back(id);
+    classes.push_back(std::vector<ENode>(1, canonical));
+    hasConstant.push_back(false);
+    constants.push_back(0.0);
+    memo[k] = id;
+    nodeCount++;
+
+    foldConstant(id, canonical);
+    return find(id);
+}
+
+void EGraph::foldConstant(int id, const ENode& node) {
+    // Análise de constantes: uma classe com valor conhecido recebe um nó "num"
+    if (hasConstant[find(id)]) return;
+
+    double value;
+    if (node.op == "num") {
+        hasConstant[id] = true;
+        constants[id] = toNumber(node.value);
+        return;
+    }
+
+    std::vector<double> args;
+    for (int child : node.children) {
+        if (!isConstant(child)) return;
+        args.push_back(constantValue(child));
+    }
+
+    if (isBinaryOp(node.op) && args.size() == 2) {
+        value = evaluateBinary(node.op, args[0], args[1]);
+    } else if (isUnaryOp(node.op) && args.size() == 1) {
+        value = evaluateUnary(node.op, args[0]);
+    } else if (isFusedOp(node.op) && args.size() == 3) {
+        value = evaluateFused(node.op, args[0], args[1], args[2]);
+    } else {
+        return;
+    }
+
+    if (!std::isfinite(value)) return;
+    merge(id, addNumber(value));
+}
+
+int EGraph::addNumber(double value) {
+    return add(ENode("num", formatNumber(value)));
+}
+
+int EGraph::addOp(const std::string& op, int a, int b) {
+    std::vector<int> children;
+    children.push_back(a);
+    children.push_back(b);
+    return add(ENode(op, "", children));
+}
+
+bool EGraph::merge(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+
+    // A classe mais antiga continua como representante
+    if (b < a) std::swap(a, b);
+    parent[b] = a;
+    classes[a].insert(classes[a].end(), classes[b].begin(), classes[b].end());
+    classes[b].clear();
+    if (hasConstant[b] && !hasConstant[a]) {
+        hasConstant[a] = true;
+        constants[a] = constants[b];
+    }
+    return true;
+}
+
+void EGraph::rebuild() {
+    // Restaura a congruência: nós que ficaram idênticos após uniões
+    // pertencem à mesma classe
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        memo.clear();
+        nodeCount = 0;
+        std::vector<std::pair<int, int>> pending;
+
+        for (size_t id = 0; id < classes.size(); id++) {
+            if (find(id) != static_cast<int>(id)) continue;
+
+            std::vector<ENode> unique;
+            std::set<std::string> seen;
+            for (auto node : classes[id]) {
+                for (auto& child : node.children) child = find(child);
+                std::string k = key(node);
+                if (!seen.insert(k).second) continue;
+                unique.push_back(node);
+
+                auto it = memo.find(k);
+                if (it != memo.end() && find(it->second) != static_cast<int>(id)) {
+                    pending.push_back(std::make_pair(it->second, id));
+                } else {
+                    memo[k] = id;
+                }
+            }
+            classes[id] = unique;
+            nodeCount += unique.size();
+        }
+
+        for (const auto& pair : pending) {
+            if (merge(pair.first, pair.second)) changed = true;
+        }
+
+        for (size_t id = 0; id < classes.size(); id++) {
+            if (find(id) != static_cast<int>(id) || hasConstant[id]) continue;
+            std::vector<ENode> current = classes[id];
+            for (const auto& node : current) {
+                foldConstant(id, node);
+                if (hasConstant[find(id)]) {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool EGraph::isConstant(int id) {
+    return hasConstant[find(id)];
+}
+
+double EGraph::constantValue(int id) {
+    return constants[find(id)];
+}
+
+const std::vector<ENode>& EGraph::nodes(int id) {
+    return classes[find(id)];
+}
+
+std::vector<int> EGraph::classIds() {
+    std::vector<int> ids;
+    for (size_t id = 0; id < classes.size(); id++) {
+        if (find(id) == static_cast<int>(id)) ids.push_back(id);
+    }
+    return ids;
+}
+
+size_t EGraph::size() const {
+    return nodeCount;
+}
+
+// ==================== CUSTOS ====================
+
+int operationCost(const std::string& op) {
+    if (op == "+" || op == "-") return 3;
+    if (op == "*") return 4;
+    if (op == "FMA" || op == "FMS" || op == "FNMA") return 5;
+    if (op == "/") return 14;
+    if (op == "SQRT") return 15;
+    if (op == "LOG") return 20;
+    if (op == "^") return 40;
+    if (op == "CALL") return 50;
+    return 0; // folhas, cópias e RETURN
+}
+
+int functionCost(const IRFunction& func) {
+    int cost = 0;
+    for (const auto& instr : func.body) cost += operationCost(instr.op);
+    return cost;
+}
+
+// ==================== REGRAS DE REESCRITA ====================
+
+namespace {
+
+bool isPowerOfTwo(double value) {
+    int exponent;
+    return value != 0.0 && std::isfinite(value) && std::fabs(std::frexp(value, &exponent)) == 0.5;
+}
+
+class RuleSet {
+private:
+    EGraph& graph;
+    bool fastMath;
+    size_t nodeLimit;
+    bool changed;
+
+    bool full() {
+        return graph.size() >= nodeLimit;
+    }
+
+    void unite(int a, int b) {
+        if (graph.merge(a, b)) changed = true;
+    }
+
+    bool constant(int id, double& value) {
+        if (!graph.isConstant(id)) return false;
+        value = graph.constantValue(id);
+        return true;
+    }
+
+    bool same(int a, int b) {
+        return graph.find(a) == graph.find(b);
+    }
+
+    // Regras exatas em ponto flutuante: valem sempre
+    void applyExact(int id, const ENode& node) {
+        if (node.children.size() != 2 || !isBinaryOp(node.op)) return;
+        int a = node.children[0], b = node.children[1];
+        double value = 0;
+        bool cb = constant(b, value);
+
+        if (node.op == "+") {
+            unite(id, graph.addOp("+", b, a));
+            if (same(a, b)) unite(id, graph.addOp("*", a, graph.addNumber(2)));
+        } else if (node.op == "*") {
+            unite(id, graph.addOp("*", b, a));
+            if (cb && value == 1) unite(id, a);
+            if (cb && value == 2) unite(id, graph.addOp("+", a, a));
+            if (same(a, b)) unite(id, graph.addOp("^", a, graph.addNumber(2)));
+        } else if (node.op == "-") {
+            if (cb && value == 0) unite(id, a);
+        } else if (node.op == "/") {
+            if (cb && value == 1) unite(id, a);
+            if (cb && isPowerOfTwo(value)) unite(id, graph.addOp("*", a, graph.addNumber(1 / value)));
+        } else if (node.op == "^" && cb) {
+            if (value == 1) unite(id, a);
+            if (value == 0) unite(id, graph.addNumber(1));
+            if (value == 2) unite(id, graph.addOp("*", a, a));
+            if (value == -1) unite(id, graph.addOp("/", graph.addNumber(1), a));
+        }
+    }
+
+    // Regras algébricas que alteram o arredondamento (apenas com fastMath)
+    void applyFastMath(int id, const ENode& node) {
+        if (node.children.size() != 2 || !isBinaryOp(node.op)) return;
+        int a = node.children[0], b = node.children[1];
+        double value = 0;
+        bool cb = constant(b, value);
+        std::vector<ENode> left = graph.nodes(a);
+        std::vector<ENode> right = graph.nodes(b);
+
+        // Associatividade: (x op y) op b -> x op (y op b)
+        if (node.op == "+" || node.op == "*") {
+            for (const auto& inner : left) {
+                if (inner.op == node.op && inner.children.size() == 2) {
+                    unite(id, graph.addOp(node.op, inner.children[0],
+                                          graph.addOp(node.op, inner.children[1], b)));
+                }
+            }
+        }
+
+        // Identidades com constantes
+        if (node.op == "+" && cb && value == 0) unite(id, a);
+        if (node.op == "*" && cb && value == 0) unite(id, graph.addNumber(0));
+        if (node.op == "-" && same(a, b)) unite(id, graph.addNumber(0));
+        if (node.op == "/" && same(a, b)) unite(id, graph.addNumber(1));
+        if (node.op == "^" && cb && value == 0.5) {
+            unite(id, graph.add(ENode("SQRT", "", std::vector<int>(1, a))));
+        }
+
+        // Fatoração: x*y ± x*z -> x*(y ± z)
+        if (node.op == "+" || node.op == "-") {
+            for (const auto& l : left) {
+                if (l.op != "*" || full()) continue;
+                for (const auto& r : right) {
+                    if (r.op == "*" && same(l.children[0], r.children[0])) {
+                        unite(id, graph.addOp("*", l.children[0],
+                                              graph.addOp(node.op, l.children[1], r.children[1])));
+                    }
+                }
+            }
+        }
+
+        // Cancelamento: (x - y) + y -> x e (x + y) - y -> x
+        for (const auto& inner : left) {
+            if (inner.children.size() != 2) continue;
+            if ((node.op == "+" && inner.op == "-") || (node.op == "-" && inner.op == "+")) {
+                if (same(inner.children[1], b)) unite(id, inner.children[0]);
+            }
+        }
+
+        // Distributividade: a*(y ± z) -> a*y ± a*z
+        if (node.op == "*") {
+            for (const auto& r : right) {
+                if ((r.op == "+" || r.op == "-") && r.children.size() == 2) {
+                    unite(id, graph.addOp(r.op, graph.addOp("*", a, r.children[0]),
+                                          graph.addOp("*", a, r.children[1])));
+                }
+            }
+        }
+
+        // Leis de potência com expoentes constantes
+        double p, q;
+        if (node.op == "*") {
+            for (const auto& l : left) {
+                if (l.op != "^" || full() || !constant(l.children[1], p)) continue;
+                if (same(l.children[0], b)) {
+                    unite(id, graph.addOp("^", b, graph.addNumber(p + 1)));
+                }
+                for (const auto& r : right) {
+                    if (r.op == "^" && constant(r.children[1], q) && same(l.children[0], r.children[0])) {
+                        unite(id, graph.addOp("^", l.children[0], graph.addNumber(p + q)));
+                    }
+                }
+            }
+        } else if (node.op == "^" && cb) {
+            for (const auto& l : left) {
+                if (l.op == "^" && constant(l.children[1], p)) {
+                    unite(id, graph.addOp("^", l.children[0], graph.addNumber(p * value)));
+                }
+            }
+        }
+    }
+
+public:
+    RuleSet(EGraph& g, bool fast, size_t limit) : graph(g), fastMath(fast), nodeLimit(limit), changed(false) {}
+
+    // Aplica todas as regras uma vez; retorna se alguma igualdade nova surgiu
+    bool apply(std::chrono::steady_clock::time_point deadline) {
+        changed = false;
+        for (int id : graph.classIds()) {
+            if (full() || std::chrono::steady_clock::now() > deadline) break;
+            std::vector<ENode> current = graph.nodes(id);
+            for (const auto& node : current) {
+                if (full()) break;
+                applyExact(id, node);
+                if (fastMath) applyFastMath(id, node);
+            }
+        }
+        return changed;
+    }
+};
+
+// Extração: menor custo de cada classe (iterado até estabilizar, pois há ciclos)
+class Extractor {
+private:
+    EGraph& graph;
+    std::map<int, int> cost;
+    std::map<int, ENode> best;
+    std::map<int, std::string> emitted;
+
+public:
+    Extractor(EGraph& g) : graph(g) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int id : graph.classIds()) {
+                for (const auto& node : graph.nodes(id)) {
+                    int total = operationCost(node.op);
+                    bool ready = true;
+                    for (int child : node.children) {
+                        auto it = cost.find(graph.find(child));
+                        if (it == cost.end()) {
+                            ready = false;
+                            break;
+                        }
+                        total += it->second;
+                    }
+                    if (!ready) continue;
+
+                    auto current = cost.find(id);
+                    if (current == cost.end() || total < current->second) {
+                        cost[id] = total;
+                        best.erase(id);
+                        best.insert(std::make_pair(id, node));
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    bool extractable(int id) {
+        return best.count(graph.find(id)) > 0;
+    }
+
+    // Emite o melhor representante da classe; retorna o operando com o valor
+    std::string emit(int id, IRModule& module, std::vector<ThreeAddressCode>& out) {
+        id = graph.find(id);
+        auto done = emitted.find(id);
+        if (done != emitted.end()) return done->second;
+
+        const ENode& node = best.at(id);
+        std::string operand;
+        if (node.op == "num" || node.op == "var") {
+            operand = node.value;
+        } else {
+            std::vector<std::string> args;
+            for (int child : node.children) args.push_back(emit(child, module, out));
+
+            operand = module.newTemp();
+            if (node.op == "CALL") {
+                out.push_back(ThreeAddressCode(operand, "CALL", node.value, joinArgs(args)));
+            } else if (args.size() == 1) {
+                out.push_back(ThreeAddressCode(operand, node.op, args[0]));
+            } else if (args.size() == 2) {
+                out.push_back(ThreeAddressCode(operand, node.op, args[0], args[1]));
+            } else {
+                out.push_back(ThreeAddressCode(operand, node.op, args[0], args[1], args[2]));
+            }
+        }
+
+        emitted[id] = operand;
+        return operand;
+    }
+};
+
+} // namespace
+
+// ==================== OTIMIZAÇÃO POR SATURAÇÃO ====================
+
+bool optimizeWithEGraph(IRFunction& func, IRModule& module, const EGraphOptions& options,
+                        EGraphResult& result) {
+    result = EGraphResult();
+    result.costBefore = result.costAfter = functionCost(func);
+    if (func.body.size() > options.nodeLimit) return false;
+
+    // Construção: cada nome aponta para a classe do seu valor atual
+    EGraph graph;
+    std::map<std::string, int> env;
+    int root = -1;
+
+    auto operand = [&](const std::string& name) {
+        if (isNumber(name)) return graph.addNumber(toNumber(name));
+        auto it = env.find(name);
+        if (it != env.end()) return it->second;
+        // Parâmetro (ou variável lida antes da primeira atribuição)
+        return graph.add(ENode("var", name));
+    };
+
+    for (const auto& instr : func.body) {
+        if (instr.op == "RETURN") {
+            // Retorno de vários valores (gradientes) não é tratado
+            if (instr.arg1.find(',') != std::string::npos) return false;
+            root = operand(instr.arg1);
+            break;
+        }
+
+        std::vector<int> children;
+        if (instr.op == "=") {
+            env[instr.result] = operand(instr.arg1);
+            continue;
+        } else if (instr.op == "CALL") {
+            for (const auto& arg : splitArgs(instr.arg2)) children.push_back(operand(arg));
+            env[instr.result] = graph.add(ENode("CALL", instr.arg1, children));
+            continue;
+        }
+
+        children.push_back(operand(instr.arg1));
+        if (!instr.arg2.empty()) children.push_back(operand(instr.arg2));
+        if (!instr.arg3.empty()) children.push_back(operand(instr.arg3));
+        env[instr.result] = graph.add(ENode(instr.op, "", children));
+    }
+
+    if (root < 0) return false;
+    graph.rebuild();
+
+    // Saturação limitada por nós, tempo e número de rodadas
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.timeLimitMs);
+    RuleSet rules(graph, options.fastMath, options.nodeLimit);
+    for (int iteration = 0; iteration < options.maxIterations; iteration++) {
+        size_t before = graph.size();
+        bool changed = rules.apply(deadline);
+        graph.rebuild();
+
+        if (!changed && graph.size() == before) {
+            result.saturated = true;
+            break;
+        }
+        if (graph.size() >= options.nodeLimit || std::chrono::steady_clock::now() > deadline) break;
+    }
+    result.nodes = graph.size();
+
+    Extractor extractor(graph);
+    if (!extractor.extractable(root)) return false;
+
+    IRFunction candidate = func;
+    candidate.body.clear();
+    std::string value = extractor.emit(root, module, candidate.body);
+    candidate.body.push_back(ThreeAddressCode("", "RETURN", value));
+
+    int cost = functionCost(candidate);
+    if (cost >= result.costBefore) return false;
+
+    func.body = candidate.body;
+    result.costAfter = cost;
+    return true;
+}
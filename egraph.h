@@ -0,0 +1,79 @@
+#ifndef EGRAPH_H
+#define EGRAPH_H
+
+#include "ir.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Nó de um e-graph: operação aplicada a classes de equivalência.
+// Folhas: "num" (literal em value) e "var" (nome em value).
+// Chamadas: op "CALL" com o nome da função em value.
+struct ENode {
+    std::string op;
+    std::string value;
+    std::vector<int> children;
+
+    ENode(const std::string& o, const std::string& v = "", const std::vector<int>& c = std::vector<int>())
+        : op(o), value(v), children(c) {}
+};
+
+struct EGraphOptions {
+    size_t nodeLimit;        // Interrompe a saturação ao atingir este número de nós
+    int timeLimitMs;         // Tempo máximo de saturação por função
+    int maxIterations;       // Rodadas de aplicação das regras
+    bool fastMath;           // Regras que alteram o arredondamento (associatividade, distributividade...)
+
+    EGraphOptions() : nodeLimit(5000), timeLimitMs(50), maxIterations(12), fastMath(false) {}
+};
+
+// Grafo de igualdades: classes de expressões equivalentes com união-busca
+// e tabela de hash para compartilhar nós idênticos
+class EGraph {
+private:
+    std::vector<int> parent;
+    std::vector<std::vector<ENode>> classes;
+    std::vector<bool> hasConstant;
+    std::vector<double> constants;
+    std::map<std::string, int> memo;
+    size_t nodeCount;
+
+    std::string key(const ENode& node);
+    void foldConstant(int id, const ENode& node);
+
+public:
+    EGraph();
+
+    int find(int id);
+    int add(const ENode& node);
+    int addNumber(double value);
+    int addOp(const std::string& op, int a, int b);
+    bool merge(int a, int b);
+    void rebuild();
+
+    bool isConstant(int id);
+    double constantValue(int id);
+    const std::vector<ENode>& nodes(int id);
+    std::vector<int> classIds();
+    size_t size() const;
+};
+
+// Custo estimado de uma operação (latência em ciclos): ^ e / são caros
+int operationCost(const std::string& op);
+int functionCost(const IRFunction& func);
+
+struct EGraphResult {
+    int costBefore;
+    int costAfter;
+    size_t nodes;
+    bool saturated;          // Nenhuma regra produziu novas igualdades antes dos limites
+
+    EGraphResult() : costBefore(0), costAfter(0), nodes(0), saturated(false) {}
+};
+
+// Satura o e-graph da expressão retornada pela função com as regras aritméticas e
+// extrai o programa equivalente de menor custo. O corpo só é substituído se o custo cair.
+bool optimizeWithEGraph(IRFunction& func, IRModule& module, const EGraphOptions& options,
+                        EGraphResult& result);
+
+#endif // EGRAPH_H
@@ -0,0 +1,151 @@
+#include "evaluator.h"
+#include <unordered_map>
+
+Evaluator::Evaluator(const std::vector<ThreeAddressCode>& code)
+    : Evaluator(buildModule(code)) {}
+
+Evaluator::Evaluator(const IRModule& irModule)
+    : module(irModule), maxDepth(1000), maxSteps(0), depth(0), steps(0), calls(0) {
+    for (const auto& func : module.functions) {
+        functions[func.name] = &func;
+    }
+}
+
+void Evaluator::setLimits(int depthLimit, long stepLimit) {
+    maxDepth = depthLimit;
+    maxSteps = stepLimit;
+}
+
+bool Evaluator::call(const std::string& name, const std::vector<double>& args, double& result) {
+    std::vector<double> results;
+    bool ok = call(name, args, results);
+    result = results.empty() ? 0.0 : results[0];
+    return ok;
+}
+
+bool Evaluator::call(const std::string& name, const std::vector<double>& args, std::vector<double>& results) {
+    errorMsg = "";
+    results.clear();
+    depth = 0;
+    long startSteps = steps;
+    long savedLimit = maxSteps;
+
+    // O limite de passos vale para esta chamada, não para o total acumulado
+    if (maxSteps > 0) maxSteps += startSteps;
+
+    auto it = functions.find(name);
+    bool ok = false;
+    if (it == functions.end()) {
+        errorMsg = "função '" + name + "' não existe";
+    } else {
+        double result;
+        ok = execute(*it->second, args, result, &results);
+        if (ok && results.empty()) results.push_back(result);
+    }
+
+    maxSteps = savedLimit;
+    return ok;
+}
+
+bool Evaluator::execute(const IRFunction& func, const std::vector<double>& args, double& result,
+                        std::vector<double>* values) {
+    if (args.size() != func.params.size()) {
+        errorMsg = "função '" + func.name + "' espera " + std::to_string(func.params.size()) +
+                   " argumento(s), mas " + std::to_string(args.size()) + " foi(ram) fornecido(s)";
+        return false;
+    }
+
+    if (depth >= maxDepth) {
+        errorMsg = "profundidade máxima de chamadas excedida em '" + func.name + "'";
+        return false;
+    }
+
+    calls++;
+    depth++;
+
+    std::unordered_map<std::string, double> vars;
+    vars.reserve(func.params.size() + (func.maxLive > 0 ? func.maxLive : func.body.size()));
+    for (size_t i = 0; i < args.size(); i++) {
+        vars[func.params[i]] = args[i];
+    }
+
+    // Variáveis lidas antes de qualquer atribuição valem 0
+    auto value = [&vars](const std::string& operand) {
+        if (isNumber(operand)) return toNumber(operand);
+        auto it = vars.find(operand);
+        return it == vars.end() ? 0.0 : it->second;
+    };
+
+    result = 0.0;
+    for (const auto& instr : func.body) {
+        if (maxSteps > 0 && steps >= maxSteps) {
+            errorMsg = "limite de instruções executadas excedido em '" + func.name + "'";
+            depth--;
+            return false;
+        }
+        steps++;
+
+        if (instr.op == "RETURN") {
+            if (instr.arg1.find(',') == std::string::npos) {
+                result = value(instr.arg1);
+                break;
+            }
+            // Vários valores: o primeiro é o resultado de um CALL
+            std::vector<std::string> operands = splitArgs(instr.arg1);
+            result = value(operands[0]);
+            if (values) {
+                for (const auto& operand : operands) values->push_back(value(operand));
+            }
+            break;
+        } else if (isCopyOp(instr.op)) {
+            vars[instr.result] = value(instr.arg1);
+        } else if (instr.op == "CALL") {
+            auto it = functions.find(instr.arg1);
+            if (it == functions.end()) {
+                errorMsg = "função '" + instr.arg1 + "' não existe";
+                depth--;
+                return false;
+            }
+
+            std::vector<double> callArgs;
+            for (const auto& arg : splitArgs(instr.arg2)) callArgs.push_back(value(arg));
+
+            double callResult;
+            if (!execute(*it->second, callArgs, callResult)) {
+                depth--;
+                return false;
+            }
+            vars[instr.result] = callResult;
+        } else if (isBinaryOp(instr.op)) {
+            vars[instr.result] = evaluateBinary(instr.op, value(instr.arg1), value(instr.arg2));
+        } else if (isUnaryOp(instr.op)) {
+            vars[instr.result] = evaluateUnary(instr.op, value(instr.arg1));
+        } else if (isFusedOp(instr.op)) {
+            vars[instr.result] = evaluateFused(instr.op, value(instr.arg1), value(instr.arg2), value(instr.arg3));
+        } else {
+            errorMsg = "operação desconhecida '" + instr.op + "'";
+            depth--;
+            return false;
+        }
+    }
+
+    depth--;
+    return true;
+}
+
+long Evaluator::getCalls() const {
+    return calls;
+}
+
+long Evaluator::getSteps() const {
+    return steps;
+}
+
+void Evaluator::resetCounters() {
+    calls = 0;
+    steps = 0;
+}
+
+std::string Evaluator::getError() const {
+    return errorMsg;
+}
@@ -0,0 +1,43 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "codegen.h"
+#include "ir.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Interpretador direto do código intermediário (valores double).
+// Usado para executar funções (--run) e para avaliações em tempo de compilação.
+class Evaluator {
+private:
+    IRModule module;
+    std::map<std::string, const IRFunction*> functions;
+    int maxDepth;            // Profundidade máxima de chamadas aninhadas
+    long maxSteps;           // Instruções executadas por chamada externa (0 = sem limite)
+    int depth;
+    long steps;
+    long calls;
+    std::string errorMsg;
+
+    bool execute(const IRFunction& func, const std::vector<double>& args, double& result,
+                 std::vector<double>* values = nullptr);
+
+public:
+    Evaluator(const std::vector<ThreeAddressCode>& code);
+    Evaluator(const IRModule& irModule);
+    Evaluator(const Evaluator&) = delete;
+    Evaluator& operator=(const Evaluator&) = delete;
+
+    void setLimits(int depthLimit, long stepLimit);
+    bool call(const std::string& name, const std::vector<double>& args, double& result);
+    // Todos os valores retornados (funções de gradiente: valor e derivadas parciais)
+    bool call(const std::string& name, const std::vector<double>& args, std::vector<double>& results);
+
+    long getCalls() const;   // Chamadas executadas (inclui a chamada externa)
+    long getSteps() const;   // Instruções executadas
+    void resetCounters();
+    std::string getError() const;
+};
+
+#endif // EVALUATOR_H
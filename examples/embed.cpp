@@ -0,0 +1,82 @@
+// Uso da libneto: compila um arquivo .neto uma vez e chama uma função muitas
+// vezes, na máquina virtual e no JIT.
+//
+//     make embed
+//     ./embed examples/valid3.neto media 1 2 10000000
+#include "neto.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static void measure(const std::string& source, neto::Backend backend, const std::string& name,
+                    const std::vector<double>& args, long calls) {
+    neto::Options options;
+    options.backend = backend;
+    options.compiler.optimize = true;
+
+    auto start = std::chrono::steady_clock::now();
+    neto::Module module = neto::compile(source, options);
+    auto compiled = std::chrono::steady_clock::now();
+    if (!module) {
+        for (const auto& diagnostic : module.diagnostics()) {
+            std::cerr << "erro " << diagnostic.phase;
+            if (diagnostic.line > 0) std::cerr << " (linha " << diagnostic.line << ", coluna " << diagnostic.column << ")";
+            std::cerr << ": " << diagnostic.message << std::endl;
+        }
+        std::exit(1);
+    }
+    neto::Function function = module.function(name);
+    if (!function) {
+        std::cerr << "função '" << name << "' não existe" << std::endl;
+        std::exit(1);
+    }
+
+    double result = function.call(args.data(), args.size());
+    if (result != result && !function.getError().empty()) {
+        std::cerr << function.getError() << std::endl;
+        std::exit(1);
+    }
+    double sum = 0.0;
+    auto loop = std::chrono::steady_clock::now();
+    for (long i = 0; i < calls; i++) sum += function.call(args.data(), args.size());
+    auto end = std::chrono::steady_clock::now();
+
+    double compileUs = std::chrono::duration<double, std::micro>(compiled - start).count();
+    double ns = std::chrono::duration<double, std::nano>(end - loop).count() / calls;
+    std::cout << (backend == neto::Backend::JIT ? "[JIT] " : "[VM] ") << name << " = " << result << ": compilação "
+              << static_cast<long>(compileUs) << " us, " << ns << " ns por chamada (" << calls << " chamadas, soma "
+              << sum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Uso: " << argv[0] << " arquivo.neto função [argumentos...] [chamadas]" << std::endl;
+        return 1;
+    }
+    std::ifstream file(argv[1]);
+    if (!file.is_open()) {
+        std::cerr << "não foi possível abrir '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    // O último número é o total de chamadas se sobrar um além da aridade
+    std::vector<double> args;
+    for (int i = 3; i < argc; i++) args.push_back(std::atof(argv[i]));
+    long calls = 10000000;
+    neto::Module probe = neto::compile(buffer.str());
+    neto::Function function = probe.function(argv[2]);
+    if (function && static_cast<int>(args.size()) == function.arity() + 1) {
+        calls = static_cast<long>(args.back());
+        args.pop_back();
+    }
+
+    measure(buffer.str(), neto::Backend::INTERPRETER, argv[2], args, calls);
+    measure(buffer.str(), neto::Backend::JIT, argv[2], args, calls);
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Execução em camadas da libneto: gera uma biblioteca com muitas funções, das
+// quais só 1% é chamada com frequência, e compara a máquina virtual, o JIT e a
+// execução em camadas no tempo até a primeira chamada e no regime permanente.
+//
+//     make tiered
+//     ./tiered [funções] [chamadas]
+#include "neto.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// f0 ... f<n-1>, todas com dois parâmetros; uma em cada oito chama a anterior
+static std::string library(int functions) {
+    std::ostringstream source;
+    for (int i = 0; i < functions; i++) {
+        source << "func f" << i << "(a, b) {\n";
+        source << "    x = a * " << (i % 7 + 2) << " + b;\n";
+        source << "    y = x * x - a / " << (i % 5 + 3) << ";\n";
+        if (i % 8 == 7) source << "    y = y + f" << (i - 1) << "(b, a);\n";
+        source << "    return y * 0.5 + " << i << ";\n";
+        source << "}\n\n";
+    }
+    return source.str();
+}
+
+static const char* backendName(neto::Backend backend) {
+    switch (backend) {
+        case neto::Backend::INTERPRETER: return "[VM]    ";
+        case neto::Backend::JIT: return "[JIT]   ";
+        default: return "[TIERED]";
+    }
+}
+
+static void measure(const std::string& source, int functions, neto::Backend backend, long calls) {
+    neto::Options options;
+    options.backend = backend;
+
+    auto start = Clock::now();
+    neto::Module module = neto::compile(source, options);
+    auto compiled = Clock::now();
+    if (!module) {
+        for (const auto& diagnostic : module.diagnostics())
+            std::cerr << "erro " << diagnostic.phase << ": " << diagnostic.message << std::endl;
+        std::exit(1);
+    }
+
+    // 1% das funções é quente
+    std::vector<neto::Function> hot;
+    for (int i = 99; i < functions; i += 100) hot.push_back(module.function("f" + std::to_string(i)));
+    double sum = hot[0](1.0, 2.0);
+    auto first = Clock::now();
+
+    // Aquecimento: cada função quente passa do limite e é traduzida
+    long warmup = options.tierThreshold + 1;
+    for (long i = 0; i < warmup; i++)
+        for (const auto& function : hot) sum += function(i * 0.001, 2.0);
+    auto warmed = Clock::now();
+    module.wait();
+
+    auto loop = Clock::now();
+    for (long i = 0; i < calls; i++) sum += hot[i % hot.size()](i * 0.001, 2.0);
+    auto end = Clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - loop).count() / calls;
+    std::cout << backendName(backend) << " compilação " << elapsedMs(start, compiled) << " ms, primeira chamada "
+              << elapsedMs(start, first) << " ms, aquecimento " << elapsedMs(first, warmed) << " ms, regime "
+              << ns << " ns por chamada (" << module.nativeFunctions() << " funções nativas, soma " << sum << ")"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int functions = argc > 1 ? std::atoi(argv[1]) : 100000;
+    long calls = argc > 2 ? std::atol(argv[2]) : 10000000;
+    if (functions < 100 || calls <= 0) {
+        std::cerr << "Uso: " << argv[0] << " [funções (>= 100)] [chamadas]" << std::endl;
+        return 1;
+    }
+
+    std::string source = library(functions);
+    std::cout << functions << " funções, " << functions / 100 << " quentes, " << calls << " chamadas" << std::endl;
+
+    measure(source, functions, neto::Backend::INTERPRETER, calls);
+    measure(source, functions, neto::Backend::JIT, calls);
+    measure(source, functions, neto::Backend::TIERED, calls);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "gradient.h"
+#include "ipo.h"
+#include <map>
+#include <vector>
+
+std::string gradientName(const std::string& name) {
+    return name + "__grad";
+}
+
+namespace {
+
+// Emite as instruções do passo reverso e acumula os adjuntos de cada nome
+class AdjointBuilder {
+private:
+    IRModule& module;
+    std::vector<ThreeAddressCode>& out;
+    std::map<std::string, std::string> adjoints;
+
+public:
+    AdjointBuilder(IRModule& m, std::vector<ThreeAddressCode>& o) : module(m), out(o) {}
+
+    std::string emit(const std::string& op, const std::string& a, const std::string& b = "") {
+        std::string temp = module.newTemp();
+        out.push_back(ThreeAddressCode(temp, op, a, b));
+        return temp;
+    }
+
+    // Produto que evita multiplicações por 1 (o adjunto inicial)
+    std::string multiply(const std::string& a, const std::string& b) {
+        if (a == "1") return b;
+        if (b == "1") return a;
+        return emit("*", a, b);
+    }
+
+    // adj(name) += term (ou -= term)
+    void accumulate(const std::string& name, const std::string& term, bool negate = false) {
+        if (isNumber(name)) return;
+
+        auto it = adjoints.find(name);
+        if (it == adjoints.end()) {
+            adjoints[name] = negate ? emit("-", "0", term) : term;
+        } else {
+            it->second = emit(negate ? "-" : "+", it->second, term);
+        }
+    }
+
+    bool find(const std::string& name, std::string& adjoint) const {
+        auto it = adjoints.find(name);
+        if (it == adjoints.end()) return false;
+        adjoint = it->second;
+        return true;
+    }
+
+    // Regras da cadeia para uma instrução "r = op ..." com adjunto g
+    void propagate(const ThreeAddressCode& instr, const std::string& g) {
+        const std::string& a = instr.arg1;
+        const std::string& b = instr.arg2;
+
+        if (instr.op == "=") {
+            accumulate(a, g);
+        } else if (instr.op == "+") {
+            accumulate(a, g);
+            accumulate(b, g);
+        } else if (instr.op == "-") {
+            accumulate(a, g);
+            accumulate(b, g, true);
+        } else if (instr.op == "*") {
+            if (!isNumber(a)) accumulate(a, multiply(g, b));
+            if (!isNumber(b)) accumulate(b, multiply(g, a));
+        } else if (instr.op == "/") {
+            // d(a/b)/da = 1/b; d(a/b)/db = -(a/b)/b
+            if (!isNumber(a)) accumulate(a, emit("/", g, b));
+            if (!isNumber(b)) accumulate(b, multiply(g, emit("/", instr.result, b)), true);
+        } else if (instr.op == "^") {
+            // d(a^b)/da = b * a^(b-1); d(a^b)/db = a^b * ln(a)
+            if (!isNumber(a)) {
+                std::string power;
+                if (isNumber(b)) {
+                    double exponent = toNumber(b) - 1;
+                    power = exponent == 0 ? "1" : emit("^", a, formatNumber(exponent));
+                } else {
+                    power = emit("^", a, emit("-", b, "1"));
+                }
+                accumulate(a, multiply(g, multiply(b, power)));
+            }
+            if (!isNumber(b)) {
+                accumulate(b, multiply(g, multiply(instr.result, emit("LOG", a))));
+            }
+        } else if (instr.op == "SQRT") {
+            accumulate(a, multiply(g, emit("/", "0.5", instr.result)));
+        } else if (instr.op == "LOG") {
+            accumulate(a, emit("/", g, a));
+        } else if (isFusedOp(instr.op)) {
+            // FMA a, b, c = a*b + c; FMS = a*b - c; FNMA = c - a*b
+            bool negateProduct = instr.op == "FNMA";
+            if (!isNumber(a)) accumulate(a, multiply(g, b), negateProduct);
+            if (!isNumber(b)) accumulate(b, multiply(g, a), negateProduct);
+            accumulate(instr.arg3, g, instr.op == "FMS");
+        }
+    }
+};
+
+} // namespace
+
+bool generateGradient(IRModule& module, const std::string& name, std::string& error) {
+    const IRFunction* original = module.find(name);
+    if (!original) {
+        error = "função '" + name + "' não existe";
+        return false;
+    }
+    if (module.find(gradientName(name))) {
+        error = "a função '" + gradientName(name) + "' já existe";
+        return false;
+    }
+
+    // Código linear: todas as chamadas expandidas
+    IRFunction source = *original;
+    if (!expandAllCalls(source, module, error)) {
+        error = "não foi possível derivar '" + name + "': " + error;
+        return false;
+    }
+
+    IRFunction grad;
+    grad.name = gradientName(name);
+    grad.params = source.params;
+
+    // Passo direto: cada definição recebe um temporário próprio, de modo que
+    // reatribuições (inclusive de parâmetros) não sobrescrevem valores
+    // necessários no passo reverso. Nomes lidos antes de definidos valem 0.
+    std::map<std::string, std::string> current;
+    for (const auto& param : source.params) current[param] = param;
+
+    std::string value = "0";
+    for (const auto& instr : source.body) {
+        ThreeAddressCode copy = instr;
+        rewriteUses(copy, [&current](const std::string& operand) -> std::string {
+            if (isNumber(operand)) return operand;
+            auto it = current.find(operand);
+            return it == current.end() ? "0" : it->second;
+        });
+
+        if (copy.op == "RETURN") {
+            value = splitArgs(copy.arg1).front();
+            break;
+        }
+        if (copy.op != "=" && !isBinaryOp(copy.op) && !isUnaryOp(copy.op) && !isFusedOp(copy.op)) {
+            error = "não foi possível derivar '" + name + "': operação '" + copy.op + "' não suportada";
+            return false;
+        }
+
+        std::string temp = module.newTemp();
+        current[copy.result] = temp;
+        copy.result = temp;
+        grad.body.push_back(copy);
+    }
+    size_t forwardSize = grad.body.size();
+
+    // Passo reverso: adjuntos propagados da última instrução para a primeira
+    std::vector<ThreeAddressCode> reverse;
+    AdjointBuilder adjoints(module, reverse);
+    adjoints.accumulate(value, "1");
+
+    for (size_t i = forwardSize; i-- > 0;) {
+        std::string g;
+        if (adjoints.find(grad.body[i].result, g)) adjoints.propagate(grad.body[i], g);
+    }
+    grad.body.insert(grad.body.end(), reverse.begin(), reverse.end());
+
+    std::vector<std::string> values(1, value);
+    for (const auto& param : grad.params) {
+        std::string g;
+        values.push_back(adjoints.find(param, g) ? g : "0");
+    }
+    grad.body.push_back(ThreeAddressCode("", "RETURN", joinArgs(values)));
+
+    module.functions.push_back(grad);
+    return true;
+}
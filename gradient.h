@@ -0,0 +1,17 @@
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include "ir.h"
+#include <string>
+
+// Nome da função de gradiente gerada para uma função (ex.: media -> media__grad)
+std::string gradientName(const std::string& name);
+
+// Diferenciação automática em modo reverso: acrescenta ao módulo a função
+// "<name>__grad", com os mesmos parâmetros, que retorna o valor de name e as
+// derivadas parciais em relação a cada parâmetro ("RETURN v, d1, ..., dn").
+// As chamadas são expandidas antes da diferenciação; funções recursivas não
+// podem ser derivadas.
+bool generateGradient(IRModule& module, const std::string& name, std::string& error);
+
+#endif // GRADIENT_H
@@ -0,0 +1,670 @@
+#include "ipo.h"
+#include "evaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// ==================== GRAFO DE CHAMADAS ====================
+
+CallGraph buildCallGraph(const IRModule& module) {
+    CallGraph graph;
+    for (const auto& func : module.functions) {
+        std::set<std::string>& callees = graph[func.name];
+        for (const auto& instr : func.body) {
+            if (instr.op == "CALL") callees.insert(instr.arg1);
+        }
+    }
+    return graph;
+}
+
+std::vector<std::vector<std::string>> callGraphSCCs(const IRModule& module) {
+    // Algoritmo de Tarjan em versão iterativa (bibliotecas podem ser grandes)
+    CallGraph graph = buildCallGraph(module);
+    std::map<std::string, int> index, lowlink;
+    std::set<std::string> onStack;
+    std::vector<std::string> stack;
+    std::vector<std::vector<std::string>> components;
+    int counter = 0;
+
+    typedef std::pair<std::string, std::set<std::string>::const_iterator> Frame;
+
+    for (const auto& func : module.functions) {
+        if (index.count(func.name)) continue;
+
+        std::vector<Frame> work;
+        index[func.name] = lowlink[func.name] = counter++;
+        stack.push_back(func.name);
+        onStack.insert(func.name);
+        work.push_back(Frame(func.name, graph[func.name].begin()));
+
+        while (!work.empty()) {
+            std::string node = work.back().first;
+            auto& it = work.back().second;
+
+            if (it != graph[node].end()) {
+                std::string next = *it;
+                ++it;
+                if (!graph.count(next)) continue; // função inexistente
+
+                if (!index.count(next)) {
+                    index[next] = lowlink[next] = counter++;
+                    stack.push_back(next);
+                    onStack.insert(next);
+                    work.push_back(Frame(next, graph[next].begin()));
+                } else if (onStack.count(next)) {
+                    lowlink[node] = std::min(lowlink[node], index[next]);
+                }
+                continue;
+            }
+
+            work.pop_back();
+            if (!work.empty()) {
+                const std::string& parent = work.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+            }
+
+            if (lowlink[node] == index[node]) {
+                std::vector<std::string> component;
+                std::string member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack.erase(member);
+                    component.push_back(member);
+                } while (member != node);
+                components.push_back(component);
+            }
+        }
+    }
+
+    return components;
+}
+
+std::set<std::string> recursiveFunctions(const IRModule& module) {
+    std::set<std::string> result;
+    CallGraph graph = buildCallGraph(module);
+
+    for (const auto& component : callGraphSCCs(module)) {
+        if (component.size() > 1) {
+            result.insert(component.begin(), component.end());
+        } else if (graph[component[0]].count(component[0])) {
+            result.insert(component[0]);
+        }
+    }
+
+    return result;
+}
+
+std::map<std::string, int> countCallSites(const IRModule& module) {
+    std::map<std::string, int> sites;
+    for (const auto& func : module.functions) {
+        for (const auto& instr : func.body) {
+            if (instr.op == "CALL") sites[instr.arg1]++;
+        }
+    }
+    return sites;
+}
+
+// ==================== FUNÇÕES INALCANÇÁVEIS ====================
+
+int removeUnreachableFunctions(IRModule& module, const std::vector<std::string>& entries) {
+    CallGraph graph = buildCallGraph(module);
+    std::set<std::string> reachable;
+    std::vector<std::string> worklist;
+
+    for (const auto& entry : entries) {
+        if (graph.count(entry) && reachable.insert(entry).second) worklist.push_back(entry);
+    }
+    while (!worklist.empty()) {
+        std::string name = worklist.back();
+        worklist.pop_back();
+        for (const auto& callee : graph[name]) {
+            if (graph.count(callee) && reachable.insert(callee).second) worklist.push_back(callee);
+        }
+    }
+
+    std::vector<IRFunction> kept;
+    for (const auto& func : module.functions) {
+        if (reachable.count(func.name)) kept.push_back(func);
+    }
+    int removed = module.functions.size() - kept.size();
+    module.functions = kept;
+    return removed;
+}
+
+// ==================== INLINING ====================
+
+namespace {
+
+// Funções chamadas de um único ponto podem ser maiores: a cópia substitui o original
+const int SINGLE_SITE_FACTOR = 4;
+// Limite de crescimento de uma função que recebe expansões
+const size_t MAX_CALLER_SIZE = 10000;
+
+bool shouldInline(size_t calleeSize, int callSites, int threshold) {
+    if (calleeSize <= static_cast<size_t>(threshold)) return true;
+    return callSites == 1 && calleeSize <= static_cast<size_t>(threshold * SINGLE_SITE_FACTOR);
+}
+
+// Copia o corpo de callee no lugar de "result = CALL callee(args)".
+// Parâmetros viram os próprios argumentos; locais e temporários recebem
+// temporários novos para não colidir com os nomes do chamador.
+void expandCall(IRModule& module, const IRFunction& callee, const ThreeAddressCode& call,
+                std::vector<ThreeAddressCode>& out) {
+    std::vector<std::string> args = splitArgs(call.arg2);
+    std::map<std::string, std::string> names;
+
+    std::set<std::string> assigned;
+    for (const auto& instr : callee.body) {
+        if (!instr.result.empty()) assigned.insert(instr.result);
+    }
+
+    for (size_t i = 0; i < callee.params.size(); i++) {
+        const std::string& param = callee.params[i];
+        if (assigned.count(param)) {
+            // Parâmetro reatribuído: precisa de uma cópia própria
+            std::string temp = module.newTemp();
+            out.push_back(ThreeAddressCode(temp, "=", args[i]));
+            names[param] = temp;
+        } else {
+            names[param] = args[i];
+        }
+    }
+
+    for (const auto& instr : callee.body) {
+        if (!instr.result.empty() && !names.count(instr.result)) {
+            names[instr.result] = module.newTemp();
+        }
+    }
+
+    auto rename = [&names](const std::string& operand) -> std::string {
+        auto it = names.find(operand);
+        return it == names.end() ? operand : it->second;
+    };
+
+    for (const auto& instr : callee.body) {
+        ThreeAddressCode copy = instr;
+        rewriteUses(copy, rename);
+
+        if (copy.op == "RETURN") {
+            // Retorno de vários valores: a chamada recebe o primeiro
+            out.push_back(ThreeAddressCode(call.result, "=", splitArgs(copy.arg1).front()));
+            return;
+        }
+
+        copy.result = rename(copy.result);
+        out.push_back(copy);
+    }
+
+    // Função sem RETURN devolve 0
+    out.push_back(ThreeAddressCode(call.result, "=", "0"));
+}
+
+} // namespace
+
+int inlineCalls(IRModule& module, int threshold, OptimizerStats& stats) {
+    if (threshold <= 0) return 0;
+
+    // Funções em ciclos nunca são expandidas: a expansão não terminaria
+    std::set<std::string> recursive = recursiveFunctions(module);
+    std::map<std::string, int> sites = countCallSites(module);
+    int inlined = 0;
+
+    // De baixo para cima: cada chamada já foi expandida dentro de suas callees
+    for (const auto& component : callGraphSCCs(module)) {
+        for (const auto& name : component) {
+            IRFunction* caller = module.find(name);
+            std::vector<ThreeAddressCode> body;
+
+            for (const auto& instr : caller->body) {
+                if (instr.op == "CALL") {
+                    const IRFunction* callee = module.find(instr.arg1);
+                    if (callee && callee != caller && !recursive.count(callee->name) &&
+                        splitArgs(instr.arg2).size() == callee->params.size() &&
+                        shouldInline(callee->body.size(), sites[callee->name], threshold) &&
+                        body.size() + callee->body.size() < MAX_CALLER_SIZE) {
+                        expandCall(module, *callee, instr, body);
+                        inlined++;
+                        continue;
+                    }
+                }
+                body.push_back(instr);
+            }
+
+            caller->body = body;
+        }
+    }
+
+    stats.inlinedCalls += inlined;
+    return inlined;
+}
+
+// ==================== ARGUMENTOS MORTOS ====================
+
+int eliminateDeadArguments(IRModule& module, const std::vector<std::string>& entries, OptimizerStats& stats) {
+    if (entries.empty()) return 0;
+    std::set<std::string> exported(entries.begin(), entries.end());
+
+    // Análise otimista: os parâmetros das funções internas começam mortos e só
+    // passam a vivos quando alguma instrução viva os lê. Um argumento só é uma
+    // leitura se o parâmetro correspondente da função chamada estiver vivo.
+    std::map<std::string, std::vector<bool>> liveParams;
+    for (const auto& func : module.functions) {
+        liveParams[func.name] = std::vector<bool>(func.params.size(), exported.count(func.name) > 0);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& func : module.functions) {
+            if (exported.count(func.name)) continue;
+
+            std::set<std::string> live;
+            for (auto it = func.body.rbegin(); it != func.body.rend(); ++it) {
+                const ThreeAddressCode& instr = *it;
+                if (instr.op != "RETURN") {
+                    if (!live.count(instr.result)) continue;
+                    live.erase(instr.result);
+                }
+
+                auto callee = liveParams.find(instr.arg1);
+                if (instr.op == "CALL" && callee != liveParams.end()) {
+                    std::vector<std::string> args = splitArgs(instr.arg2);
+                    for (size_t i = 0; i < args.size() && i < callee->second.size(); i++) {
+                        if (callee->second[i] && !isNumber(args[i])) live.insert(args[i]);
+                    }
+                } else {
+                    for (const auto& use : instructionUses(instr)) live.insert(use);
+                }
+            }
+
+            std::vector<bool>& params = liveParams[func.name];
+            for (size_t i = 0; i < func.params.size(); i++) {
+                if (!params[i] && live.count(func.params[i])) {
+                    params[i] = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Remove os parâmetros mortos e os argumentos nas chamadas
+    int removedParams = 0, removedArgs = 0;
+    for (auto& func : module.functions) {
+        const std::vector<bool>& params = liveParams[func.name];
+        std::vector<std::string> kept;
+        for (size_t i = 0; i < func.params.size(); i++) {
+            if (params[i]) kept.push_back(func.params[i]);
+        }
+        removedParams += func.params.size() - kept.size();
+        func.params = kept;
+    }
+    if (removedParams == 0) return 0;
+
+    for (auto& func : module.functions) {
+        bool rewritten = false;
+        for (auto& instr : func.body) {
+            if (instr.op != "CALL") continue;
+            auto callee = liveParams.find(instr.arg1);
+            if (callee == liveParams.end()) continue;
+
+            std::vector<std::string> args = splitArgs(instr.arg2);
+            std::vector<std::string> kept;
+            for (size_t i = 0; i < args.size(); i++) {
+                if (i >= callee->second.size() || callee->second[i]) kept.push_back(args[i]);
+            }
+            if (kept.size() != args.size()) {
+                removedArgs += args.size() - kept.size();
+                instr.arg2 = joinArgs(kept);
+                rewritten = true;
+            }
+        }
+
+        // Os cálculos que só alimentavam os argumentos removidos ficam mortos
+        if (rewritten) stats.deadAssignments += eliminateDeadCode(func);
+    }
+
+    stats.removedParameters += removedParams;
+    stats.removedArguments += removedArgs;
+    return removedParams;
+}
+
+bool expandAllCalls(IRFunction& func, IRModule& module, std::string& error) {
+    std::set<std::string> recursive = recursiveFunctions(module);
+
+    // Cada rodada expande as chamadas atuais; as chamadas copiadas dos corpos
+    // expandidos ficam para a rodada seguinte
+    bool expanded = true;
+    while (expanded) {
+        expanded = false;
+        std::vector<ThreeAddressCode> body;
+
+        for (const auto& instr : func.body) {
+            if (instr.op != "CALL") {
+                body.push_back(instr);
+                continue;
+            }
+
+            const IRFunction* callee = module.find(instr.arg1);
+            if (!callee) {
+                error = "função '" + instr.arg1 + "' não existe";
+                return false;
+            }
+            if (recursive.count(callee->name) || callee->name == func.name) {
+                error = "a função '" + callee->name + "' é recursiva e não pode ser expandida";
+                return false;
+            }
+            if (splitArgs(instr.arg2).size() != callee->params.size()) {
+                error = "chamada a '" + callee->name + "' com número incorreto de argumentos";
+                return false;
+            }
+            if (body.size() + callee->body.size() >= MAX_CALLER_SIZE) {
+                error = "a expansão de '" + func.name + "' excede " + std::to_string(MAX_CALLER_SIZE) + " instruções";
+                return false;
+            }
+
+            expandCall(module, *callee, instr, body);
+            expanded = true;
+        }
+
+        func.body = body;
+    }
+
+    return true;
+}
+
+// ==================== PROPAGAÇÃO INTERPROCEDURAL DE CONSTANTES ====================
+
+int evaluateConstantCalls(IRModule& module, int maxDepth, long maxSteps, OptimizerStats& stats) {
+    // Todas as funções são puras e totais sobre doubles: uma chamada com
+    // argumentos literais pode ser substituída pelo seu resultado
+    Evaluator evaluator(module);
+    evaluator.setLimits(maxDepth, maxSteps);
+
+    // Resultado de cada chamada já avaliada ("f(1, 2)"); vazio = falhou
+    std::map<std::string, std::string> cache;
+    int evaluated = 0;
+
+    for (auto& func : module.functions) {
+        for (auto& instr : func.body) {
+            if (instr.op != "CALL") continue;
+
+            std::vector<std::string> args = splitArgs(instr.arg2);
+            bool constant = true;
+            std::vector<double> values;
+            for (const auto& arg : args) {
+                if (!isNumber(arg)) {
+                    constant = false;
+                    break;
+                }
+                values.push_back(toNumber(arg));
+            }
+            if (!constant) continue;
+
+            std::string key = instr.arg1 + "(" + instr.arg2 + ")";
+            auto cached = cache.find(key);
+            if (cached == cache.end()) {
+                double result;
+                std::string literal = "";
+                if (evaluator.call(instr.arg1, values, result) && std::isfinite(result)) {
+                    literal = formatNumber(result);
+                } else {
+                    stats.abandonedEvaluations++;
+                }
+                cached = cache.insert(std::make_pair(key, literal)).first;
+            }
+
+            if (cached->second.empty()) continue;
+
+            instr = ThreeAddressCode(instr.result, "=", cached->second);
+            evaluated++;
+        }
+    }
+
+    stats.evaluatedCalls += evaluated;
+    return evaluated;
+}
+
+// ==================== ESPECIALIZAÇÃO DE FUNÇÕES ====================
+
+namespace {
+
+// Nome da cópia: f__spec_<posição>_<valor> para cada argumento constante
+std::string mangleSpecialization(const std::string& callee,
+                                 const std::vector<std::pair<size_t, std::string>>& constants) {
+    std::string name = callee + "__spec";
+    for (const auto& constant : constants) {
+        name += "_" + std::to_string(constant.first) + "_";
+        for (char c : constant.second) {
+            if (c == '.') name += 'p';
+            else if (c == '-') name += 'm';
+            else if (c != '+') name += c;
+        }
+    }
+    return name;
+}
+
+} // namespace
+
+int specializeCalls(IRModule& module, int minCalls, size_t budget, OptimizerStats& stats) {
+    std::set<std::string> recursive = recursiveFunctions(module);
+
+    // Padrão (função + argumentos constantes) -> locais de chamada (função, instrução)
+    typedef std::pair<std::string, std::vector<std::pair<size_t, std::string>>> Pattern;
+    std::map<Pattern, std::vector<std::pair<size_t, size_t>>> patterns;
+
+    for (size_t f = 0; f < module.functions.size(); f++) {
+        const IRFunction& func = module.functions[f];
+        for (size_t i = 0; i < func.body.size(); i++) {
+            const ThreeAddressCode& instr = func.body[i];
+            if (instr.op != "CALL" || recursive.count(instr.arg1)) continue;
+
+            std::vector<std::string> args = splitArgs(instr.arg2);
+            Pattern pattern(instr.arg1, std::vector<std::pair<size_t, std::string>>());
+            for (size_t a = 0; a < args.size(); a++) {
+                if (isNumber(args[a])) pattern.second.push_back(std::make_pair(a, args[a]));
+            }
+
+            // Todos constantes: tratado pela avaliação em tempo de compilação
+            if (pattern.second.empty() || pattern.second.size() == args.size()) continue;
+            patterns[pattern].push_back(std::make_pair(f, i));
+        }
+    }
+
+    int rewritten = 0;
+    for (const auto& entry : patterns) {
+        const Pattern& pattern = entry.first;
+        const auto& sites = entry.second;
+        if (static_cast<int>(sites.size()) < minCalls) continue;
+
+        const IRFunction* callee = module.find(pattern.first);
+        if (!callee) continue;
+
+        // Uma função do programa com o nome da cópia não é a cópia: sufixo
+        // numérico até um nome livre (ou o de uma cópia criada antes)
+        std::string mangled = mangleSpecialization(pattern.first, pattern.second);
+        std::string name = mangled;
+        for (int k = 2; module.find(name) && !stats.clones.count(name); k++) {
+            name = mangled + "_" + std::to_string(k);
+        }
+
+        if (!module.find(name)) {
+            // Cópia: argumentos constantes viram atribuições no início do corpo
+            IRFunction clone;
+            clone.name = name;
+            size_t next = 0;
+            for (size_t p = 0; p < callee->params.size(); p++) {
+                if (next < pattern.second.size() && pattern.second[next].first == p) {
+                    clone.body.push_back(ThreeAddressCode(callee->params[p], "=", pattern.second[next].second));
+                    next++;
+                } else {
+                    clone.params.push_back(callee->params[p]);
+                }
+            }
+            clone.body.insert(clone.body.end(), callee->body.begin(), callee->body.end());
+
+            OptimizerStats cloneStats;
+            simplifyFunction(clone, cloneStats);
+
+            // Só vale a pena se o dobramento de constantes encolheu a função
+            size_t original = callee->body.size();
+            if (clone.body.size() >= original || clone.body.size() > budget) continue;
+
+            budget -= clone.body.size();
+            stats.clonedInstructions += clone.body.size();
+            stats.specializedFunctions++;
+            stats.specializations.push_back(pattern.first + " -> " + name + " (" +
+                std::to_string(original) + " -> " + std::to_string(clone.body.size()) +
+                " instruções, " + std::to_string(sites.size()) + " chamada(s))");
+            stats.specializationSavings += (original - clone.body.size()) * sites.size();
+
+            // A inserção pode realocar o vetor: callee não é mais usado daqui em diante
+            module.functions.push_back(clone);
+            stats.clones.insert(name);
+        }
+
+        // Redirecionar as chamadas, mantendo apenas os argumentos não constantes
+        for (const auto& site : sites) {
+            ThreeAddressCode& instr = module.functions[site.first].body[site.second];
+            std::vector<std::string> args = splitArgs(instr.arg2);
+            std::vector<std::string> remaining;
+            size_t next = 0;
+            for (size_t a = 0; a < args.size(); a++) {
+                if (next < pattern.second.size() && pattern.second[next].first == a) {
+                    next++;
+                } else {
+                    remaining.push_back(args[a]);
+                }
+            }
+            instr = ThreeAddressCode(instr.result, "CALL", name, joinArgs(remaining));
+            rewritten++;
+        }
+    }
+
+    return rewritten;
+}
+
+// ==================== UNIÃO DE FUNÇÕES IDÊNTICAS ====================
+
+namespace {
+
+// Forma canônica do corpo: parâmetros viram p0, p1... pela posição e os demais
+// nomes v0, v1... pela ordem de aparição. Literais e nomes de funções chamadas
+// são mantidos.
+std::string canonicalBody(const IRFunction& func) {
+    std::map<std::string, std::string> names;
+    for (size_t i = 0; i < func.params.size(); i++) names[func.params[i]] = "p" + std::to_string(i);
+
+    auto canonical = [&names](const std::string& name) -> std::string {
+        if (name.empty() || isNumber(name)) return name;
+        auto it = names.find(name);
+        if (it != names.end()) return it->second;
+        std::string renamed = "v" + std::to_string(names.size());
+        names[name] = renamed;
+        return renamed;
+    };
+
+    std::string text = std::to_string(func.params.size()) + "\n";
+    for (const auto& instr : func.body) {
+        ThreeAddressCode copy = instr;
+        rewriteUses(copy, canonical);
+        copy.result = canonical(copy.result);
+        text += copy.result + "=" + copy.op + " " + copy.arg1 + "|" + copy.arg2 + "|" + copy.arg3 + "\n";
+    }
+    return text;
+}
+
+} // namespace
+
+int mergeIdenticalFunctions(IRModule& module, const std::vector<std::string>& entries, OptimizerStats& stats) {
+    std::set<std::string> exported(entries.begin(), entries.end());
+    auto isEntry = [&exported](const std::string& name) { return exported.empty() || exported.count(name) > 0; };
+    int merged = 0;
+    size_t sizeBefore = moduleSize(module);
+
+    // Após redirecionar as chamadas, as funções chamadoras podem ficar idênticas
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        // Hash da forma canônica; as colisões são resolvidas comparando o texto.
+        // Cada classe guarda as funções idênticas na ordem do módulo
+        std::map<size_t, std::vector<std::pair<std::string, std::vector<std::string>>>> buckets;
+        std::hash<std::string> hasher;
+
+        for (const auto& func : module.functions) {
+            std::string text = canonicalBody(func);
+            auto& bucket = buckets[hasher(text)];
+            bool found = false;
+            for (auto& candidate : bucket) {
+                if (candidate.first == text) {
+                    candidate.second.push_back(func.name);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) bucket.push_back(std::make_pair(text, std::vector<std::string>(1, func.name)));
+        }
+
+        // A função mantida é a primeira entrada da classe (ou a primeira, se
+        // nenhuma for entrada): as internas são removidas e apenas entradas
+        // idênticas a outra entrada viram apelidos
+        std::map<std::string, std::string> replacement;
+        for (const auto& bucket : buckets) {
+            for (const auto& group : bucket.second) {
+                const std::vector<std::string>& names = group.second;
+                if (names.size() < 2) continue;
+                std::string target = names[0];
+                for (const auto& name : names) {
+                    if (isEntry(name)) {
+                        target = name;
+                        break;
+                    }
+                }
+                for (const auto& name : names) {
+                    if (name != target) replacement[name] = target;
+                }
+            }
+        }
+        if (replacement.empty()) break;
+
+        std::vector<IRFunction> kept;
+        for (auto& func : module.functions) {
+            for (auto& instr : func.body) {
+                if (instr.op != "CALL") continue;
+                auto it = replacement.find(instr.arg1);
+                if (it != replacement.end()) instr.arg1 = it->second;
+            }
+
+            auto it = replacement.find(func.name);
+            if (it == replacement.end()) {
+                kept.push_back(func);
+                continue;
+            }
+
+            if (!isEntry(func.name)) {
+                merged++;
+                changed = true;
+                continue;
+            }
+
+            // Apelido: só compensa se o corpo for maior que o encaminhamento
+            if (func.body.size() <= 2) {
+                kept.push_back(func);
+                continue;
+            }
+            std::string temp = module.newTemp();
+            func.body.clear();
+            func.body.push_back(ThreeAddressCode(temp, "CALL", it->second, joinArgs(func.params)));
+            func.body.push_back(ThreeAddressCode("", "RETURN", temp));
+            kept.push_back(func);
+            merged++;
+            changed = true;
+        }
+        module.functions = kept;
+    }
+
+    stats.mergedFunctions += merged;
+    stats.mergeSavings += sizeBefore - moduleSize(module);
+    return merged;
+}
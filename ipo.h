@@ -0,0 +1,61 @@
+#ifndef IPO_H
+#define IPO_H
+
+#include "ir.h"
+#include "optimizer.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ==================== GRAFO DE CHAMADAS ====================
+
+// Para cada função, as funções que ela chama (sem repetição)
+typedef std::map<std::string, std::set<std::string>> CallGraph;
+
+CallGraph buildCallGraph(const IRModule& module);
+
+// Componentes fortemente conexas em ordem "de baixo para cima":
+// as funções chamadas aparecem antes das que as chamam
+std::vector<std::vector<std::string>> callGraphSCCs(const IRModule& module);
+
+// Funções que participam de algum ciclo de chamadas (inclusive recursão direta)
+std::set<std::string> recursiveFunctions(const IRModule& module);
+
+// Número de instruções CALL que chamam cada função
+std::map<std::string, int> countCallSites(const IRModule& module);
+
+// ==================== PASSES INTERPROCEDURAIS ====================
+
+// Remove as funções que não são alcançáveis a partir das entradas
+int removeUnreachableFunctions(IRModule& module, const std::vector<std::string>& entries);
+
+// Expande em linha as chamadas a funções pequenas (custo <= threshold)
+int inlineCalls(IRModule& module, int threshold, OptimizerStats& stats);
+
+// Remove parâmetros que nunca são lidos das funções internas (que não são entradas)
+// e os argumentos correspondentes em todas as chamadas. Parâmetros que apenas
+// repassam valores a parâmetros mortos (inclusive em recursões) também são removidos.
+int eliminateDeadArguments(IRModule& module, const std::vector<std::string>& entries, OptimizerStats& stats);
+
+// Expande todas as chamadas de func, recursivamente, até restar código linear.
+// Falha (com a mensagem em error) se alguma função chamada for recursiva.
+bool expandAllCalls(IRFunction& func, IRModule& module, std::string& error);
+
+// Avalia em tempo de compilação as chamadas cujos argumentos são todos literais.
+// Os limites de profundidade e de passos impedem que recursões infinitas travem o compilador.
+int evaluateConstantCalls(IRModule& module, int maxDepth, long maxSteps, OptimizerStats& stats);
+
+// Cria cópias especializadas de funções chamadas repetidamente com os mesmos
+// argumentos constantes (ex.: escala(x, 1000)) e redireciona essas chamadas.
+// budget limita o total de instruções adicionadas pelas cópias.
+int specializeCalls(IRModule& module, int minCalls, size_t budget, OptimizerStats& stats);
+
+// Une funções com corpos idênticos a menos de renomeação de parâmetros, locais e
+// temporários: as chamadas passam a usar a primeira entrada entre elas (ou a primeira,
+// se nenhuma for entrada) e as demais viram apelidos ("t = CALL original(params)") se
+// forem entradas, ou são removidas caso contrário.
+// entries vazio: todas as funções são entradas.
+int mergeIdenticalFunctions(IRModule& module, const std::vector<std::string>& entries, OptimizerStats& stats);
+
+#endif // IPO_H
@@ -0,0 +1,196 @@
+#include "ir.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+std::string IRModule::newTemp() {
+    return "t" + std::to_string(tempCounter++);
+}
+
+IRFunction* IRModule::find(const std::string& name) {
+    for (auto& func : functions) {
+        if (func.name == name) return &func;
+    }
+    return nullptr;
+}
+
+bool isNumber(const std::string& operand) {
+    if (operand.empty()) return false;
+
+    // Identificadores nunca começam com dígito, '.' ou '-'
+    size_t start = operand[0] == '-' ? 1 : 0;
+    if (start >= operand.size()) return false;
+    char c = operand[start];
+    if (!std::isdigit(static_cast<unsigned char>(c)) && c != '.') return false;
+
+    char* end = nullptr;
+    std::strtod(operand.c_str(), &end);
+    return end && *end == '\0';
+}
+
+double toNumber(const std::string& operand) {
+    return std::strtod(operand.c_str(), nullptr);
+}
+
+std::string formatNumber(double value) {
+    // Menor representação que preserva o valor exato do double
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    if (std::strtod(buffer, nullptr) != value) {
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    }
+    return buffer;
+}
+
+bool isTempName(const std::string& name) {
+    if (name.size() < 2 || name[0] != 't') return false;
+    for (size_t i = 1; i < name.size(); i++) {
+        if (!std::isdigit(static_cast<unsigned char>(name[i]))) return false;
+    }
+    return true;
+}
+
+std::vector<std::string> splitArgs(const std::string& args) {
+    std::vector<std::string> result;
+    std::string current;
+
+    for (char c : args) {
+        if (c == ',') {
+            result.push_back(current);
+            current.clear();
+        } else if (c != ' ') {
+            current += c;
+        }
+    }
+    if (!current.empty()) result.push_back(current);
+
+    return result;
+}
+
+std::string joinArgs(const std::vector<std::string>& args) {
+    std::string result;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (i > 0) result += ", ";
+        result += args[i];
+    }
+    return result;
+}
+
+bool isBinaryOp(const std::string& op) {
+    return op == "+" || op == "-" || op == "*" || op == "/" || op == "^";
+}
+
+double evaluateBinary(const std::string& op, double a, double b) {
+    if (op == "+") return a + b;
+    if (op == "-") return a - b;
+    if (op == "*") return a * b;
+    if (op == "/") return a / b;
+    if (op == "^") return std::pow(a, b);
+    return 0.0;
+}
+
+bool isUnaryOp(const std::string& op) {
+    return op == "SQRT" || op == "LOG";
+}
+
+double evaluateUnary(const std::string& op, double a) {
+    if (op == "SQRT") return std::sqrt(a);
+    if (op == "LOG") return std::log(a);
+    return 0.0;
+}
+
+bool isCopyOp(const std::string& op) {
+    return op == "=" || op == "SPILL" || op == "RELOAD";
+}
+
+bool isFusedOp(const std::string& op) {
+    return op == "FMA" || op == "FMS" || op == "FNMA";
+}
+
+double evaluateFused(const std::string& op, double a, double b, double c) {
+    // std::fma é exata (um arredondamento) com ou sem suporte do processador
+    if (op == "FMA") return std::fma(a, b, c);
+    if (op == "FMS") return std::fma(a, b, -c);
+    if (op == "FNMA") return std::fma(-a, b, c);
+    return 0.0;
+}
+
+std::vector<std::string> instructionUses(const ThreeAddressCode& instr) {
+    std::vector<std::string> uses;
+    auto add = [&uses](const std::string& operand) {
+        if (!operand.empty() && !isNumber(operand)) uses.push_back(operand);
+    };
+
+    if (instr.op == "CALL") {
+        for (const auto& arg : splitArgs(instr.arg2)) add(arg);
+    } else if (instr.op == "RETURN") {
+        for (const auto& value : splitArgs(instr.arg1)) add(value);
+    } else if (isCopyOp(instr.op) || isUnaryOp(instr.op)) {
+        add(instr.arg1);
+    } else if (isBinaryOp(instr.op)) {
+        add(instr.arg1);
+        add(instr.arg2);
+    } else if (isFusedOp(instr.op)) {
+        add(instr.arg1);
+        add(instr.arg2);
+        add(instr.arg3);
+    }
+
+    return uses;
+}
+
+IRModule buildModule(const std::vector<ThreeAddressCode>& code) {
+    IRModule module;
+    IRFunction* current = nullptr;
+
+    auto noteName = [&module](const std::string& name) {
+        // Garante que novos temporários não colidam com nomes existentes
+        if (isTempName(name)) {
+            int index = std::atoi(name.c_str() + 1);
+            if (index >= module.tempCounter) module.tempCounter = index + 1;
+        }
+    };
+
+    for (const auto& instr : code) {
+        if (instr.op == "FUNC") {
+            module.functions.push_back(IRFunction());
+            current = &module.functions.back();
+            current->name = instr.arg1;
+            current->params = splitArgs(instr.arg2);
+            if (isNumber(instr.arg3)) {
+                current->maxLive = std::atoi(instr.arg3.c_str());
+            } else {
+                current->annotation = instr.arg3;
+            }
+            for (const auto& param : current->params) noteName(param);
+        } else if (instr.op == "ENDFUNC") {
+            current = nullptr;
+        } else if (current) {
+            current->body.push_back(instr);
+            noteName(instr.result);
+            for (const auto& use : instructionUses(instr)) noteName(use);
+        }
+    }
+
+    return module;
+}
+
+std::vector<ThreeAddressCode> flattenModule(const IRModule& module) {
+    std::vector<ThreeAddressCode> code;
+
+    for (const auto& func : module.functions) {
+        std::string header = func.maxLive >= 0 ? std::to_string(func.maxLive) : func.annotation;
+        code.push_back(ThreeAddressCode("", "FUNC", func.name, joinArgs(func.params), header));
+        code.insert(code.end(), func.body.begin(), func.body.end());
+        code.push_back(ThreeAddressCode("", "ENDFUNC", func.name));
+    }
+
+    return code;
+}
+
+size_t moduleSize(const IRModule& module) {
+    size_t size = 0;
+    for (const auto& func : module.functions) size += func.body.size();
+    return size;
+}
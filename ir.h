@@ -0,0 +1,89 @@
+#ifndef IR_H
+#define IR_H
+
+#include "codegen.h"
+#include <string>
+#include <vector>
+
+// Função do código intermediário (instruções entre FUNC e ENDFUNC)
+struct IRFunction {
+    std::string name;
+    std::vector<std::string> params;
+    std::vector<ThreeAddressCode> body;
+    int maxLive = -1;        // Registradores virtuais do quadro (-1: não calculado)
+    std::string annotation;  // Resumo da alocação de registradores (cabeçalho do .ir)
+};
+
+// Módulo: todas as funções do programa e o contador global de temporários
+struct IRModule {
+    std::vector<IRFunction> functions;
+    int tempCounter;
+
+    IRModule() : tempCounter(0) {}
+
+    std::string newTemp();
+    IRFunction* find(const std::string& name);
+};
+
+// Conversão entre a lista linear de instruções e o módulo
+IRModule buildModule(const std::vector<ThreeAddressCode>& code);
+std::vector<ThreeAddressCode> flattenModule(const IRModule& module);
+
+// Operandos
+bool isNumber(const std::string& operand);
+double toNumber(const std::string& operand);
+std::string formatNumber(double value);
+bool isTempName(const std::string& name);
+
+// Lista de argumentos no formato "a, b, c" (usado por CALL e FUNC)
+std::vector<std::string> splitArgs(const std::string& args);
+std::string joinArgs(const std::vector<std::string>& args);
+
+// Operações aritméticas binárias (+, -, *, /, ^)
+bool isBinaryOp(const std::string& op);
+double evaluateBinary(const std::string& op, double a, double b);
+
+// Operações unárias geradas pelo otimizador ("t = SQRT x") e pelo gradiente ("t = LOG x")
+bool isUnaryOp(const std::string& op);
+double evaluateUnary(const std::string& op, double a);
+
+// Multiplicação-adição fundida (um único arredondamento):
+// FMA a, b, c = a*b + c; FMS a, b, c = a*b - c; FNMA a, b, c = c - a*b
+bool isFusedOp(const std::string& op);
+double evaluateFused(const std::string& op, double a, double b, double c);
+
+// Cópias: "=" e as cópias entre registrador e pilha inseridas pelo alocador
+// ("r1 = RELOAD s0", "s0 = SPILL r1")
+bool isCopyOp(const std::string& op);
+
+// Operandos lidos por uma instrução (apenas nomes, sem literais)
+std::vector<std::string> instructionUses(const ThreeAddressCode& instr);
+
+// Substitui cada operando lido pela instrução segundo a função fornecida
+template <typename F>
+void rewriteUses(ThreeAddressCode& instr, F rename) {
+    if (instr.op == "CALL") {
+        std::vector<std::string> args = splitArgs(instr.arg2);
+        for (auto& arg : args) arg = rename(arg);
+        instr.arg2 = joinArgs(args);
+    } else if (instr.op == "RETURN") {
+        // Funções de gradiente retornam vários valores: "RETURN v, d1, d2"
+        std::vector<std::string> values = splitArgs(instr.arg1);
+        for (auto& value : values) value = rename(value);
+        instr.arg1 = joinArgs(values);
+    } else if (isCopyOp(instr.op) || isUnaryOp(instr.op)) {
+        instr.arg1 = rename(instr.arg1);
+    } else if (isBinaryOp(instr.op)) {
+        instr.arg1 = rename(instr.arg1);
+        instr.arg2 = rename(instr.arg2);
+    } else if (isFusedOp(instr.op)) {
+        instr.arg1 = rename(instr.arg1);
+        instr.arg2 = rename(instr.arg2);
+        instr.arg3 = rename(instr.arg3);
+    }
+}
+
+// Número de instruções úteis (sem FUNC/ENDFUNC)
+size_t moduleSize(const IRModule& module);
+
+#endif // IR_H
@@ -0,0 +1,595 @@
+#include "jit.h"
+#include "lowering.h"
+#include "regalloc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if JIT_AVAILABLE
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+using x86::Operand;
+using x86::RAX;
+using x86::RSP;
+using x86::RDI;
+
+// Profundidade máxima de chamadas aninhadas, a mesma da máquina virtual
+const int MAX_DEPTH = 1000;
+
+// Prefixos e códigos das instruções SSE2 escalares (prefixo, 0F, código)
+const uint8_t SD = 0xF2, PD = 0x66;
+const uint8_t MOVSD_LOAD = 0x10, MOVSD_STORE = 0x11, MOVAPD = 0x28;
+const uint8_t SQRTSD = 0x51, ADDSD = 0x58, MULSD = 0x59, SUBSD = 0x5C, DIVSD = 0x5E;
+
+// Codificação das instruções x86-64 usadas pelo JIT
+class Assembler {
+private:
+    std::vector<uint8_t>& out;
+
+    // Campo ModRM (e SIB/deslocamento) para reg com operando em memória [base + disp]
+    void memoryOperand(int reg, int base, int32_t disp) {
+        emit(0x80 | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7) == RSP) emit(0x24);
+        emit32(disp);
+    }
+
+public:
+    explicit Assembler(std::vector<uint8_t>& code) : out(code) {}
+
+    size_t position() const { return out.size(); }
+    void emit(uint8_t byte) { out.push_back(byte); }
+
+    void emit32(int32_t value) {
+        uint32_t bits = static_cast<uint32_t>(value);
+        for (int i = 0; i < 4; i++) emit((bits >> (8 * i)) & 0xFF);
+    }
+
+    void emit64(uint64_t value) {
+        for (int i = 0; i < 8; i++) emit((value >> (8 * i)) & 0xFF);
+    }
+
+    void patch32(size_t at, int32_t value) {
+        uint32_t bits = static_cast<uint32_t>(value);
+        for (int i = 0; i < 4; i++) out[at + i] = (bits >> (8 * i)) & 0xFF;
+    }
+
+    void rex(bool r, bool b) {
+        if (r || b) emit(0x40 | (r ? 4 : 0) | (b ? 1 : 0));
+    }
+
+    // op xmm, xmm
+    void sse(uint8_t prefix, uint8_t opcode, int reg, int rm) {
+        emit(prefix);
+        rex(reg >= 8, rm >= 8);
+        emit(0x0F);
+        emit(opcode);
+        emit(0xC0 | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    // op xmm, [base + disp] (ou op [base + disp], xmm, conforme o código)
+    void sseMemory(uint8_t prefix, uint8_t opcode, int reg, int base, int32_t disp) {
+        emit(prefix);
+        rex(reg >= 8, false);
+        emit(0x0F);
+        emit(opcode);
+        memoryOperand(reg, base, disp);
+    }
+
+    // op xmm, [rip + disp32]: retorna a posição do deslocamento, ajustado depois
+    size_t sseRelative(uint8_t prefix, uint8_t opcode, int reg) {
+        emit(prefix);
+        rex(reg >= 8, false);
+        emit(0x0F);
+        emit(opcode);
+        emit(((reg & 7) << 3) | 5);
+        size_t at = position();
+        emit32(0);
+        return at;
+    }
+
+    // VFMADD231SD e semelhantes (VEX.66.0F38.W1): dst = src1 * src2 +/- dst
+    void vex(uint8_t opcode, int dst, int src1, int src2) {
+        vexPrefix(opcode, dst, src1, src2 >= 8);
+        emit(0xC0 | ((dst & 7) << 3) | (src2 & 7));
+    }
+
+    void vexMemory(uint8_t opcode, int dst, int src1, int base, int32_t disp) {
+        vexPrefix(opcode, dst, src1, false);
+        memoryOperand(dst, base, disp);
+    }
+
+    size_t vexRelative(uint8_t opcode, int dst, int src1) {
+        vexPrefix(opcode, dst, src1, false);
+        emit(((dst & 7) << 3) | 5);
+        size_t at = position();
+        emit32(0);
+        return at;
+    }
+
+    void vexPrefix(uint8_t opcode, int dst, int src1, bool extendedRm) {
+        emit(0xC4);
+        emit(((dst >= 8 ? 0 : 1) << 7) | (1 << 6) | ((extendedRm ? 0 : 1) << 5) | 0x02);
+        emit(0x80 | ((~src1 & 0xF) << 3) | 0x01);
+        emit(opcode);
+    }
+
+    // mov r64, [base + disp] / mov [base + disp], r64 / mov r64, imm64
+    void load(int reg, int base, int32_t disp) {
+        emit(0x48);
+        emit(0x8B);
+        memoryOperand(reg, base, disp);
+    }
+
+    void store(int base, int32_t disp, int reg) {
+        emit(0x48);
+        emit(0x89);
+        memoryOperand(reg, base, disp);
+    }
+
+    void immediate(int reg, uint64_t value) {
+        emit(0x48);
+        emit(0xB8 + reg);
+        emit64(value);
+    }
+
+    // btc r64, 63: troca o bit de sinal
+    void flipSign(int reg) {
+        emit(0x48); emit(0x0F); emit(0xBA);
+        emit(0xF8 | reg);
+        emit(63);
+    }
+
+    // xor r32, r32
+    void clear(int reg) {
+        emit(0x31);
+        emit(0xC0 | (reg << 3) | reg);
+    }
+
+    // test r64, r64; je rel32: retorna a posição do deslocamento
+    size_t jumpIfZero(int reg) {
+        emit(0x48); emit(0x85);
+        emit(0xC0 | (reg << 3) | reg);
+        emit(0x0F); emit(0x84);
+        size_t at = position();
+        emit32(0);
+        return at;
+    }
+
+    void prologue(int32_t frame) {
+        emit(0x55);                              // push rbp
+        emit(0x48); emit(0x89); emit(0xE5);      // mov rbp, rsp
+        if (frame > 0) {
+            emit(0x48); emit(0x81); emit(0xEC);  // sub rsp, frame
+            emit32(frame);
+        }
+    }
+
+    void epilogue(bool frame = true) {
+        if (frame) emit(0xC9);                   // leave
+        emit(0xC3);                              // ret
+    }
+
+    // call rel32: retorna a posição do deslocamento
+    size_t callRelative() {
+        emit(0xE8);
+        size_t at = position();
+        emit32(0);
+        return at;
+    }
+
+    void callAbsolute(const void* target) {
+        immediate(RAX, reinterpret_cast<uint64_t>(target));
+        emit(0xFF);
+        emit(0xD0);                              // call rax
+    }
+};
+
+uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double callPow(double x, double y) {
+    return std::pow(x, y);
+}
+
+double callLog(double x) {
+    return std::log(x);
+}
+
+double callFma(double x, double y, double z) {
+    return std::fma(x, y, z);
+}
+
+bool hasFMA() {
+#if JIT_AVAILABLE && defined(__GNUC__)
+    return __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+// Saída da tradução compartilhada (lowering.h) em código de máquina. As
+// constantes de cada função ficam logo após o seu código; as chamadas entre
+// funções são ajustadas no fim do módulo, pelos índices das funções
+class ByteEmitter : public x86::Emitter {
+private:
+    Assembler& as;
+    const std::unordered_map<std::string, int>& index;
+
+    std::vector<double> constants;
+    std::unordered_map<uint64_t, int> constantIndex;        // Bits da constante -> posição
+    std::vector<std::pair<size_t, int>> constantFixups;    // (deslocamento, constante)
+    size_t returnJump;
+
+    int constant(double value) {
+        auto it = constantIndex.find(bitsOf(value));
+        if (it != constantIndex.end()) return it->second;
+        int k = constants.size();
+        constants.push_back(value);
+        constantIndex[bitsOf(value)] = k;
+        return k;
+    }
+
+    static uint8_t opcode(x86::Sse op) {
+        switch (op) {
+            case x86::Sse::MOVSD: return MOVSD_LOAD;
+            case x86::Sse::MOVAPD: return MOVAPD;
+            case x86::Sse::ADD: return ADDSD;
+            case x86::Sse::SUB: return SUBSD;
+            case x86::Sse::MUL: return MULSD;
+            case x86::Sse::DIV: return DIVSD;
+            default: return SQRTSD;
+        }
+    }
+
+public:
+    std::vector<std::pair<size_t, int>> callFixups;        // (deslocamento, função chamada)
+
+    ByteEmitter(Assembler& assembler, const std::unordered_map<std::string, int>& functionIndex)
+        : as(assembler), index(functionIndex), returnJump(0) {}
+
+    void beginFunction(const std::string&) override {
+        constants.clear();
+        constantIndex.clear();
+        constantFixups.clear();
+    }
+
+    // Constantes após o código da função, alinhadas em 8 bytes
+    void endFunction() override {
+        while (as.position() % 8 != 0) as.emit(0xCC);
+        std::vector<size_t> positions;
+        for (double value : constants) {
+            positions.push_back(as.position());
+            as.emit64(bitsOf(value));
+        }
+        for (const auto& fixup : constantFixups) {
+            as.patch32(fixup.first, static_cast<int32_t>(positions[fixup.second] - (fixup.first + 4)));
+        }
+    }
+
+    void prologue(int32_t frame) override { as.prologue(frame); }
+    void epilogue(bool frame) override { as.epilogue(frame); }
+
+    void sse(x86::Sse op, int reg, const Operand& src) override {
+        uint8_t prefix = op == x86::Sse::MOVAPD ? PD : SD;
+        if (src.kind == Operand::REGISTER) {
+            as.sse(prefix, opcode(op), reg, src.reg);
+        } else if (src.kind == Operand::MEMORY) {
+            as.sseMemory(prefix, opcode(op), reg, src.reg, src.disp);
+        } else {
+            constantFixups.push_back(std::make_pair(as.sseRelative(prefix, opcode(op), reg), constant(src.value)));
+        }
+    }
+
+    void storeDouble(const Operand& dst, int reg) override {
+        as.sseMemory(SD, MOVSD_STORE, reg, dst.reg, dst.disp);
+    }
+
+    void fused(const std::string& op, int dst, int src1, const Operand& src2) override {
+        uint8_t code = op == "FMA" ? 0xB9 : op == "FMS" ? 0xBB : 0xBD;
+        if (src2.kind == Operand::REGISTER) {
+            as.vex(code, dst, src1, src2.reg);
+        } else if (src2.kind == Operand::MEMORY) {
+            as.vexMemory(code, dst, src1, src2.reg, src2.disp);
+        } else {
+            constantFixups.push_back(std::make_pair(as.vexRelative(code, dst, src1), constant(src2.value)));
+        }
+    }
+
+    void load(int reg, const Operand& src) override {
+        if (src.kind == Operand::MEMORY) as.load(reg, src.reg, src.disp);
+        else as.immediate(reg, bitsOf(src.value));
+    }
+
+    void store(const Operand& dst, int reg) override { as.store(dst.reg, dst.disp, reg); }
+    void flipSign(int reg) override { as.flipSign(reg); }
+    void clear(int reg) override { as.clear(reg); }
+
+    void jumpIfZero(int reg) override { returnJump = as.jumpIfZero(reg); }
+
+    void returnLabel() override {
+        as.patch32(returnJump, static_cast<int32_t>(as.position() - (returnJump + 4)));
+    }
+
+    void callFunction(const std::string& name) override {
+        callFixups.push_back(std::make_pair(as.callRelative(), index.at(name)));
+    }
+
+    void callLibrary(x86::Library function) override {
+        switch (function) {
+            case x86::Library::POW: as.callAbsolute(reinterpret_cast<const void*>(&callPow)); break;
+            case x86::Library::LOG: as.callAbsolute(reinterpret_cast<const void*>(&callLog)); break;
+            case x86::Library::FMA: as.callAbsolute(reinterpret_cast<const void*>(&callFma)); break;
+        }
+    }
+};
+
+} // namespace
+
+JIT::JIT(const std::vector<ThreeAddressCode>& code)
+    : memory(nullptr), memorySize(0), codeBytes(0) {
+    load(buildModule(code));
+}
+
+JIT::JIT(const IRModule& module)
+    : memory(nullptr), memorySize(0), codeBytes(0) {
+    load(module);
+}
+
+JIT::~JIT() {
+#if JIT_AVAILABLE
+    if (memory) munmap(memory, memorySize);
+#endif
+}
+
+// Erros que a máquina virtual encontraria ao executar a função: chamada a
+// função inexistente ou com aridade errada, operação desconhecida e cadeias de
+// chamadas mais profundas que o limite (uma função neto recursiva nunca termina,
+// pois não há desvios)
+void JIT::checkCalls(const IRModule& module) {
+    size_t count = module.functions.size();
+    std::vector<std::vector<int>> callees(count);
+    for (size_t f = 0; f < count; f++) {
+        for (const auto& instr : module.functions[f].body) {
+            if (instr.op == "RETURN") break;
+            if (instr.op == "CALL") {
+                auto callee = index.find(instr.arg1);
+                size_t args = splitArgs(instr.arg2).size();
+                if (callee == index.end()) {
+                    functions[f].error = "função '" + instr.arg1 + "' não existe";
+                } else if (static_cast<int>(args) != functions[callee->second].params) {
+                    functions[f].error = "função '" + instr.arg1 + "' espera " +
+                                         std::to_string(functions[callee->second].params) + " argumento(s), mas " +
+                                         std::to_string(args) + " foi(ram) fornecido(s)";
+                } else {
+                    callees[f].push_back(callee->second);
+                    continue;
+                }
+                break;
+            }
+            bool known = isCopyOp(instr.op) || isBinaryOp(instr.op) || isUnaryOp(instr.op) || isFusedOp(instr.op);
+            if (!known) {
+                functions[f].error = "operação desconhecida '" + instr.op + "'";
+                break;
+            }
+        }
+    }
+
+    // Profundidade da cadeia de chamadas mais longa de cada função, em pós-ordem
+    // com pilha explícita (MAX_DEPTH + 1: recursiva ou profunda demais)
+    std::vector<int> depth(count, 0);
+    std::vector<char> state(count, 0);   // 0: não visitada, 1: na pilha, 2: concluída
+    for (size_t root = 0; root < count; root++) {
+        if (state[root]) continue;
+        std::vector<std::pair<int, size_t>> stack(1, std::make_pair(static_cast<int>(root), size_t(0)));
+        state[root] = 1;
+        while (!stack.empty()) {
+            int f = stack.back().first;
+            size_t& next = stack.back().second;
+            if (next < callees[f].size()) {
+                int callee = callees[f][next++];
+                if (state[callee] == 0) {
+                    state[callee] = 1;
+                    stack.push_back(std::make_pair(callee, size_t(0)));
+                } else if (state[callee] == 1) {
+                    depth[f] = MAX_DEPTH + 1;
+                    if (functions[f].error.empty()) {
+                        functions[f].error = "profundidade máxima de chamadas excedida em '" + functions[callee].name + "'";
+                    }
+                }
+                continue;
+            }
+
+            for (int callee : callees[f]) {
+                if (state[callee] != 2) continue;
+                depth[f] = std::max(depth[f], depth[callee]);
+                if (functions[f].error.empty() && !functions[callee].error.empty()) {
+                    functions[f].error = functions[callee].error;
+                }
+            }
+            depth[f] = std::min(depth[f] + 1, MAX_DEPTH + 1);
+            if (depth[f] > MAX_DEPTH && functions[f].error.empty()) {
+                functions[f].error = "profundidade máxima de chamadas excedida em '" + functions[f].name + "'";
+            }
+            state[f] = 2;
+            stack.pop_back();
+        }
+    }
+
+    // Membros de um ciclo concluídos antes de o ciclo ser detectado
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t f = 0; f < count; f++) {
+            if (!functions[f].error.empty()) continue;
+            for (int callee : callees[f]) {
+                if (!functions[callee].error.empty()) {
+                    functions[f].error = functions[callee].error;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void JIT::load(const IRModule& module) {
+    functions.resize(module.functions.size());
+    size_t maxValues = 1;
+    for (size_t i = 0; i < module.functions.size(); i++) {
+        const IRFunction& func = module.functions[i];
+        functions[i].name = func.name;
+        functions[i].params = func.params.size();
+        index[func.name] = i;
+        for (const auto& instr : func.body) {
+            if (instr.op != "RETURN") continue;
+            functions[i].values = splitArgs(instr.arg1).size();
+            maxValues = std::max(maxValues, static_cast<size_t>(functions[i].values));
+            break;
+        }
+    }
+    results.assign(maxValues, 0.0);
+
+#if JIT_AVAILABLE
+    checkCalls(module);
+
+    // Valores em XMM0-XMM13; nenhum registrador sobrevive a um CALL (System V)
+    IRModule allocated = module;
+    RegAllocOptions regalloc;
+    regalloc.registers = x86::VALUE_REGISTERS;
+    regalloc.convention = "sysv";
+    RegisterAllocator allocator(regalloc);
+    if (!allocator.allocate(allocated)) {
+        errorMsg = allocator.getError();
+        for (auto& function : functions) function.error = errorMsg;
+        return;
+    }
+
+    std::unordered_map<std::string, int> values;
+    for (const auto& function : functions) values[function.name] = function.values;
+    bool fma3 = hasFMA();
+
+    std::vector<uint8_t> code;
+    Assembler as(code);
+    ByteEmitter emitter(as, index);
+    for (size_t i = 0; i < allocated.functions.size(); i++) {
+        NativeFunction& native = functions[i];
+        if (!native.error.empty()) continue;
+
+        native.body = as.position();
+        x86::lowerFunction(allocated.functions[i], values, fma3, emitter);
+
+        // Ponto de entrada: argumentos lidos do vetor em RDI (os nove primeiros
+        // em diante vão para a pilha, alinhada em 16 bytes); uma função com mais
+        // de um valor recebe em RDI o vetor de resultados do JIT
+        while (as.position() % 16 != 0) as.emit(0xCC);
+        native.entry = as.position();
+        int stackArgs = std::max(native.params - 8, 0);
+        as.prologue((8 * stackArgs + 15) & ~15);
+        for (int j = 8; j < native.params; j++) {
+            as.load(RAX, RDI, 8 * j);
+            as.store(RSP, 8 * (j - 8), RAX);
+        }
+        for (int j = 0; j < std::min(native.params, 8); j++) as.sseMemory(SD, MOVSD_LOAD, j, RDI, 8 * j);
+        if (native.values > 1) as.immediate(RDI, reinterpret_cast<uint64_t>(results.data()));
+        emitter.callFixups.push_back(std::make_pair(as.callRelative(), static_cast<int>(i)));
+        as.epilogue();
+        while (as.position() % 16 != 0) as.emit(0xCC);
+    }
+    for (const auto& fixup : emitter.callFixups) {
+        as.patch32(fixup.first, static_cast<int32_t>(functions[fixup.second].body - (fixup.first + 4)));
+    }
+    codeBytes = code.size();
+    if (code.empty()) return;
+
+    // Páginas graváveis durante a cópia e apenas executáveis depois (W^X)
+    size_t page = 4096;
+    memorySize = (code.size() + page - 1) / page * page;
+    void* pages = mmap(nullptr, memorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED) {
+        memorySize = 0;
+        errorMsg = "não foi possível reservar memória para o código nativo";
+        for (auto& function : functions) function.error = errorMsg;
+        return;
+    }
+    memory = static_cast<uint8_t*>(pages);
+    std::memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, memorySize, PROT_READ | PROT_EXEC) != 0) {
+        errorMsg = "não foi possível tornar o código nativo executável";
+        for (auto& function : functions) function.error = errorMsg;
+    }
+#else
+    errorMsg = "compilação JIT disponível apenas em x86-64 (System V)";
+    for (auto& function : functions) function.error = errorMsg;
+#endif
+}
+
+int JIT::function(const std::string& name) const {
+    auto it = index.find(name);
+    return it == index.end() ? -1 : it->second;
+}
+
+int JIT::arity(int function) const {
+    return functions[function].params;
+}
+
+JIT::EntryPoint JIT::entry(int function) const {
+    if (!memory || !functions[function].error.empty()) return nullptr;
+    return reinterpret_cast<EntryPoint>(memory + functions[function].entry);
+}
+
+bool JIT::call(int function, const double* args, double& result) {
+    errorMsg = "";
+    EntryPoint native = entry(function);
+    if (!native) {
+        errorMsg = functions[function].error;
+        return false;
+    }
+    result = native(args);
+    return true;
+}
+
+bool JIT::call(const std::string& name, const std::vector<double>& args, double& result) {
+    std::vector<double> values;
+    bool ok = call(name, args, values);
+    result = values.empty() ? 0.0 : values[0];
+    return ok;
+}
+
+bool JIT::call(const std::string& name, const std::vector<double>& args, std::vector<double>& values) {
+    errorMsg = "";
+    values.clear();
+
+    int function = this->function(name);
+    if (function < 0) {
+        errorMsg = "função '" + name + "' não existe";
+        return false;
+    }
+    if (static_cast<int>(args.size()) != functions[function].params) {
+        errorMsg = "função '" + name + "' espera " + std::to_string(functions[function].params) +
+                   " argumento(s), mas " + std::to_string(args.size()) + " foi(ram) fornecido(s)";
+        return false;
+    }
+
+    double result;
+    if (!call(function, args.data(), result)) return false;
+    if (functions[function].values > 1) {
+        values.assign(results.begin(), results.begin() + functions[function].values);
+    } else {
+        values.push_back(result);
+    }
+    return true;
+}
+
+size_t JIT::codeSize() const {
+    return codeBytes;
+}
+
+std::string JIT::getError() const {
+    return errorMsg;
+}
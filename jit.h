@@ -0,0 +1,78 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "codegen.h"
+#include "ir.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Geração de código nativo: x86-64 com a convenção System V (Linux, BSD, macOS)
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#define JIT_AVAILABLE 1
+#else
+#define JIT_AVAILABLE 0
+#endif
+
+// Função compilada: corpo com a convenção System V (argumentos em XMM0-XMM7 e
+// na pilha, resultado em XMM0) e ponto de entrada double(const double*)
+struct NativeFunction {
+    std::string name;
+    int params;
+    int values;              // Valores retornados (funções de gradiente retornam vários)
+    size_t body;             // Posição do corpo no código gerado
+    size_t entry;            // Posição do ponto de entrada
+    std::string error;       // Função não compilada: erro informado ao chamá-la
+
+    NativeFunction() : params(0), values(1), body(0), entry(0) {}
+};
+
+// Compilador JIT para x86-64. O código intermediário passa pela alocação de
+// registradores (convenção sysv, 14 registradores: XMM0-XMM13 guardam valores,
+// XMM14 e XMM15 são temporários da tradução) e cada instrução vira uma ou
+// poucas instruções SSE2 escalares, pela mesma tradução do backend de assembly
+// (lowering.h), emitida em bytes. O código é escrito em páginas obtidas com
+// mmap e só então tornado executável: nenhuma página é gravável e executável
+// ao mesmo tempo. ^ e LOG chamam pow e log da libm; FMA, FMS e FNMA usam as
+// instruções FMA3 quando o processador as tem (ou fma da libm).
+class JIT {
+public:
+    typedef double (*EntryPoint)(const double* args);
+
+private:
+    std::vector<NativeFunction> functions;
+    std::unordered_map<std::string, int> index;
+    std::vector<double> results;     // Valores de um RETURN com mais de um valor (passado em RDI)
+    uint8_t* memory;
+    size_t memorySize;
+    size_t codeBytes;
+    std::string errorMsg;
+
+    void load(const IRModule& module);
+    void checkCalls(const IRModule& module);
+
+public:
+    JIT(const std::vector<ThreeAddressCode>& code);
+    JIT(const IRModule& module);
+    ~JIT();
+
+    JIT(const JIT&) = delete;
+    JIT& operator=(const JIT&) = delete;
+
+    // Índice de uma função para chamadas repetidas sem busca pelo nome (-1 se não existe)
+    int function(const std::string& name) const;
+    int arity(int function) const;
+    // Ponto de entrada nativo (nullptr se a função não foi compilada)
+    EntryPoint entry(int function) const;
+
+    bool call(int function, const double* args, double& result);
+    bool call(const std::string& name, const std::vector<double>& args, double& result);
+    // Todos os valores retornados (funções de gradiente: valor e derivadas parciais)
+    bool call(const std::string& name, const std::vector<double>& args, std::vector<double>& results);
+
+    size_t codeSize() const;         // Bytes de código gerado (corpos, entradas e constantes)
+    std::string getError() const;
+};
+
+#endif // JIT_H
@@ -499,6 +499,7 @@ char *yytext;
 #include "ast.h"
 #include "parser.tab.hh"
 #include <cstdlib>
+#include <deque>
 #include <string>
 #include <sstream>
 
@@ -530,9 +531,14 @@ TokenType bison_token_to_type(int bison_token) {
     }
 }
 
+// Tokens da análise atual: o parser só lê o lexema, e todos são liberados
+// juntos ao final (release_tokens)
+static std::deque<Token> tokens;
+
 // Função auxiliar para criar token
 #define TOKEN(t) do { \
-    yylval.token_val = new Token(bison_token_to_type(t), std::string(yytext), yylineno, yycolumn); \
+    tokens.emplace_back(bison_token_to_type(t), std::string(yytext, yyleng), yylineno, yycolumn); \
+    yylval.token_val = &tokens.back(); \
     yycolumn += yyleng; \
     return t; \
 } while(0)
@@ -1976,5 +1982,12 @@ void yyfree (void * ptr )
 void reset_lexer() {
     yycolumn = 1;
     yylineno = 1;
+    // Após um erro de sintaxe sobra entrada no buffer: a próxima análise lê do novo yyin
+    YY_FLUSH_BUFFER;
+}
+
+// Libera os tokens da última análise (o parser já copiou os lexemas para a AST)
+void release_tokens() {
+    std::deque<Token>().swap(tokens);
 }
 
@@ -0,0 +1,130 @@
+#include "liveness.h"
+#include <functional>
+#include <queue>
+#include <set>
+
+LivenessInfo analyzeLiveness(const IRFunction& func) {
+    LivenessInfo info;
+    std::map<std::string, int> current;   // Valor atual de cada nome
+
+    for (const auto& param : func.params) {
+        current[param] = info.intervals.size();
+        info.intervals.push_back(LiveInterval(param, -1, true));
+    }
+
+    for (size_t i = 0; i < func.body.size(); i++) {
+        const ThreeAddressCode& instr = func.body[i];
+        std::map<std::string, int> reads;
+
+        // Os operandos são lidos antes da escrita do resultado
+        for (const auto& use : instructionUses(instr)) {
+            auto it = current.find(use);
+            if (it == current.end()) continue;
+            reads[use] = it->second;
+            info.intervals[it->second].end = i;
+        }
+        info.uses.push_back(reads);
+
+        if (instr.result.empty()) {
+            info.defs.push_back(-1);
+        } else {
+            current[instr.result] = info.intervals.size();
+            info.defs.push_back(info.intervals.size());
+            info.intervals.push_back(LiveInterval(instr.result, i, false));
+        }
+    }
+
+    return info;
+}
+
+namespace {
+
+// Atribuição gulosa em ordem de início: na instrução i, os valores lidos pela
+// última vez liberam seus registradores antes da escrita do resultado. Como os
+// intervalos formam um grafo de intervalos, o guloso usa o mínimo possível.
+// Retorna o registrador de cada intervalo (-1 para parâmetros).
+std::vector<int> assignSlots(const IRFunction& func, const LivenessInfo& info, int& slotCount) {
+    std::vector<int> slots(info.intervals.size(), -1);
+    std::vector<std::vector<int>> endingAt(func.body.size());
+    for (size_t v = 0; v < info.intervals.size(); v++) {
+        const LiveInterval& interval = info.intervals[v];
+        if (!interval.param && interval.end > interval.start) endingAt[interval.end].push_back(v);
+    }
+
+    // Menor registrador livre primeiro: numeração estável
+    std::priority_queue<int, std::vector<int>, std::greater<int>> free;
+    slotCount = 0;
+
+    for (size_t i = 0; i < func.body.size(); i++) {
+        for (int v : endingAt[i]) free.push(slots[v]);
+
+        int def = info.defs[i];
+        if (def < 0) continue;
+
+        if (free.empty()) {
+            slots[def] = slotCount++;
+        } else {
+            slots[def] = free.top();
+            free.pop();
+        }
+
+        // Valor nunca lido: o registrador fica livre logo após a escrita
+        if (info.intervals[def].end == info.intervals[def].start) free.push(slots[def]);
+    }
+
+    return slots;
+}
+
+} // namespace
+
+int maxLive(const IRFunction& func) {
+    int slotCount;
+    assignSlots(func, analyzeLiveness(func), slotCount);
+    return slotCount;
+}
+
+int frameSize(const IRFunction& func) {
+    std::set<std::string> params(func.params.begin(), func.params.end());
+    std::set<std::string> names;
+    for (const auto& instr : func.body) {
+        if (!instr.result.empty() && !params.count(instr.result)) names.insert(instr.result);
+        for (const auto& use : instructionUses(instr)) {
+            if (!params.count(use)) names.insert(use);
+        }
+    }
+    return names.size();
+}
+
+int reuseTempSlots(IRFunction& func) {
+    LivenessInfo info = analyzeLiveness(func);
+    int slotCount;
+    std::vector<int> slots = assignSlots(func, info, slotCount);
+
+    // Nomes dos registradores, sem colidir com parâmetros chamados tN
+    std::set<std::string> params(func.params.begin(), func.params.end());
+    std::vector<std::string> names;
+    for (int next = 0; static_cast<int>(names.size()) < slotCount; next++) {
+        std::string name = "t" + std::to_string(next);
+        if (!params.count(name)) names.push_back(name);
+    }
+
+    auto slotName = [&](int value) {
+        const LiveInterval& interval = info.intervals[value];
+        return interval.param ? interval.name : names[slots[value]];
+    };
+
+    for (size_t i = 0; i < func.body.size(); i++) {
+        ThreeAddressCode& instr = func.body[i];
+        const std::map<std::string, int>& reads = info.uses[i];
+        rewriteUses(instr, [&](const std::string& operand) -> std::string {
+            if (operand.empty() || isNumber(operand)) return operand;
+            auto it = reads.find(operand);
+            // Nome lido antes de qualquer atribuição vale 0
+            return it == reads.end() ? "0" : slotName(it->second);
+        });
+        if (info.defs[i] >= 0) instr.result = slotName(info.defs[i]);
+    }
+
+    func.maxLive = slotCount;
+    return slotCount;
+}
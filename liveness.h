@@ -0,0 +1,42 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "ir.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// Intervalo de vida de um valor. Um nome reatribuído gera um intervalo por
+// definição; parâmetros começam antes da primeira instrução.
+struct LiveInterval {
+    std::string name;
+    int start;               // Instrução que define o valor (-1: parâmetro)
+    int end;                 // Última instrução que o lê (start se nunca lido)
+    bool param;
+
+    LiveInterval(const std::string& n, int s, bool p) : name(n), start(s), end(s), param(p) {}
+};
+
+// Resultado da análise de vivacidade de uma função (código linear)
+struct LivenessInfo {
+    std::vector<LiveInterval> intervals;         // Em ordem de início
+    std::vector<int> defs;                       // Intervalo definido por cada instrução (-1: nenhum)
+    std::vector<std::map<std::string, int>> uses;// Intervalo lido por nome em cada instrução
+};
+
+LivenessInfo analyzeLiveness(const IRFunction& func);
+
+// Máximo de valores (exceto parâmetros) vivos ao mesmo tempo: o número de
+// registradores virtuais necessários para o quadro da função
+int maxLive(const IRFunction& func);
+
+// Nomes distintos (exceto parâmetros): o quadro de um avaliador que reserva
+// uma posição por nome
+int frameSize(const IRFunction& func);
+
+// Renomeia locais e temporários para registradores virtuais reutilizáveis
+// (t0, t1, ...), com o menor número possível, e grava esse número em func.maxLive.
+// Leituras de nomes ainda não atribuídos viram o literal 0.
+int reuseTempSlots(IRFunction& func);
+
+#endif // LIVENESS_H
@@ -0,0 +1,287 @@
+#include "lowering.h"
+#include <algorithm>
+#include <set>
+
+namespace x86 {
+
+Operand xmm(int reg) {
+    Operand op;
+    op.kind = Operand::REGISTER;
+    op.reg = reg;
+    return op;
+}
+
+Operand memory(int base, int32_t disp) {
+    Operand op;
+    op.kind = Operand::MEMORY;
+    op.reg = base;
+    op.disp = disp;
+    return op;
+}
+
+namespace {
+
+// Tradução de uma função já alocada em registradores XMM. Quadro: sN em
+// -8(N+1)(%rbp), o ponteiro dos valores retornados (funções de gradiente), a
+// área de salvamento dos XMM nas chamadas à libm e, junto de RSP, os argumentos
+// de pilha dos CALL e 8 posições de passagem. Funções folha que não usam a
+// pilha não montam quadro
+class FunctionLowering {
+private:
+    const IRFunction& func;
+    const std::unordered_map<std::string, int>& values;
+    bool fma3;
+    Emitter& out;
+
+    bool frameless;          // Função folha sem memória: sem prólogo nem epílogo
+    int32_t valuesSlot;      // Ponteiro double* recebido em RDI (relativo a RBP)
+    int32_t saveArea;        // Área de salvamento dos XMM (relativa a RBP)
+    int stackArgs;           // Maior número de argumentos de pilha de um CALL
+
+    Operand operand(const std::string& name) const {
+        Operand op;
+        if (isNumber(name)) {
+            op.value = toNumber(name);
+        } else if (name[0] == 'r') {
+            op = xmm(std::stoi(name.substr(1)));
+        } else if (name[0] == 's') {
+            op = memory(RBP, -8 * (std::stoi(name.substr(1)) + 1));
+        } else {
+            // aN: argumentos de pilha acima do endereço de retorno
+            op = memory(RBP, 16 + 8 * std::stoi(name.substr(1)));
+        }
+        return op;
+    }
+
+    Operand staging(size_t j) const {
+        return memory(RSP, 8 * (stackArgs + j));
+    }
+
+    void loadRegister(int reg, const Operand& src) {
+        if (src.kind == Operand::REGISTER) {
+            if (src.reg != reg) out.sse(Sse::MOVAPD, reg, src);
+        } else {
+            out.sse(Sse::MOVSD, reg, src);
+        }
+    }
+
+    void move(const Operand& dst, const Operand& src) {
+        if (dst.kind == Operand::REGISTER) {
+            loadRegister(dst.reg, src);
+        } else if (src.kind == Operand::REGISTER) {
+            out.storeDouble(dst, src.reg);
+        } else {
+            out.load(RAX, src);
+            out.store(dst, RAX);
+        }
+    }
+
+    void arithmetic(Sse op, bool commutative, const Operand& dst, const Operand& x, const Operand& y) {
+        int target = dst.kind == Operand::REGISTER ? dst.reg : TEMP;
+        bool xInTarget = x.kind == Operand::REGISTER && x.reg == target;
+        bool yInTarget = y.kind == Operand::REGISTER && y.reg == target;
+        if (yInTarget && !xInTarget) {
+            if (commutative) {
+                out.sse(op, target, x);
+            } else {
+                loadRegister(TEMP, x);
+                out.sse(op, TEMP, y);
+                loadRegister(target, xmm(TEMP));
+            }
+        } else {
+            loadRegister(target, x);
+            out.sse(op, target, y);
+        }
+        if (dst.kind != Operand::REGISTER) move(dst, xmm(TEMP));
+    }
+
+    // FMA3: o acumulador (terceiro operando) fica em XMM15
+    void fused(const std::string& op, const Operand& dst, Operand x, Operand y, const Operand& z) {
+        if (x.kind != Operand::REGISTER) std::swap(x, y);
+        if (x.kind != Operand::REGISTER) {
+            loadRegister(TEMP2, x);
+            x = xmm(TEMP2);
+        }
+        loadRegister(TEMP, z);
+        out.fused(op, TEMP, x.reg, y);
+        move(dst, xmm(TEMP));
+    }
+
+    // Chamada à libm: os registradores vivos após a instrução são guardados,
+    // pois a convenção System V não preserva nenhum registrador XMM
+    void library(Library function, const Operand& dst, const std::vector<Operand>& args, const std::set<int>& live) {
+        for (int reg : live) out.storeDouble(memory(RBP, saveArea - 8 * reg), reg);
+
+        // Argumentos passam pelas posições de passagem para não sobrescrever
+        // um operando ainda não lido
+        for (size_t j = 0; j < args.size(); j++) {
+            if (args[j].kind == Operand::REGISTER) move(staging(j), args[j]);
+        }
+        for (size_t j = 0; j < args.size(); j++) {
+            loadRegister(j, args[j].kind == Operand::REGISTER ? staging(j) : args[j]);
+        }
+
+        out.callLibrary(function);
+        move(dst, xmm(0));
+        for (int reg : live) {
+            if (dst.kind != Operand::REGISTER || reg != dst.reg) loadRegister(reg, memory(RBP, saveArea - 8 * reg));
+        }
+    }
+
+    // Argumentos: os de pilha vão direto para junto de RSP; os de registrador
+    // são guardados antes de qualquer XMM0-XMM7 ser sobrescrito
+    void call(const std::string& callee, const std::vector<std::string>& names, const Operand& dst) {
+        std::vector<Operand> args;
+        for (const auto& name : names) args.push_back(operand(name));
+
+        for (size_t j = 8; j < args.size(); j++) move(memory(RSP, 8 * (j - 8)), args[j]);
+        size_t inRegisters = std::min<size_t>(args.size(), 8);
+        for (size_t j = 0; j < inRegisters; j++) {
+            if (args[j].kind == Operand::REGISTER && args[j].reg != static_cast<int>(j)) move(staging(j), args[j]);
+        }
+        for (size_t j = 0; j < inRegisters; j++) {
+            if (args[j].kind != Operand::REGISTER) {
+                loadRegister(j, args[j]);
+            } else if (args[j].reg != static_cast<int>(j)) {
+                loadRegister(j, staging(j));
+            }
+        }
+
+        // Apenas o primeiro valor de uma função de gradiente é usado
+        if (values.at(callee) > 1) out.clear(RDI);
+        out.callFunction(callee);
+        move(dst, xmm(0));
+    }
+
+    // Primeiro valor em XMM0; com mais de um valor, todos vão também para o
+    // vetor recebido (se não for NULL)
+    void ret(const std::vector<std::string>& names) {
+        if (names.size() > 1) {
+            out.load(RCX, memory(RBP, valuesSlot));
+            out.jumpIfZero(RCX);
+            for (size_t j = 0; j < names.size(); j++) move(memory(RCX, 8 * j), operand(names[j]));
+            out.returnLabel();
+        }
+        loadRegister(0, operand(names[0]));
+        out.epilogue(!frameless);
+    }
+
+public:
+    FunctionLowering(const IRFunction& function, const std::unordered_map<std::string, int>& functionValues,
+                     bool useFma3, Emitter& emitter)
+        : func(function), values(functionValues), fma3(useFma3), out(emitter),
+          frameless(false), valuesSlot(0), saveArea(0), stackArgs(0) {}
+
+    void translate() {
+        // Código após o primeiro RETURN nunca executa
+        size_t n = 0;
+        while (n < func.body.size() && func.body[n].op != "RETURN") n++;
+        if (n < func.body.size()) n++;
+
+        int slots = 0;
+        frameless = values.at(func.name) == 1;
+        for (size_t i = 0; i < n; i++) {
+            const ThreeAddressCode& instr = func.body[i];
+            std::vector<std::string> names = instructionUses(instr);
+            names.push_back(instr.result);
+            for (const auto& name : names) {
+                if (!name.empty() && name[0] == 's' && !isNumber(name)) slots = std::max(slots, std::stoi(name.substr(1)) + 1);
+                if (!name.empty() && (name[0] == 's' || name[0] == 'a') && !isNumber(name)) frameless = false;
+            }
+            if (instr.op == "CALL" || instr.op == "^" || instr.op == "LOG") frameless = false;
+            if (isFusedOp(instr.op) && !fma3) frameless = false;
+            if (instr.op == "CALL") {
+                stackArgs = std::max(stackArgs, static_cast<int>(splitArgs(instr.arg2).size()) - 8);
+            }
+        }
+        valuesSlot = -8 * (slots + 1);
+        saveArea = -8 * (slots + 2);
+        int32_t frame = 8 * (slots + 1 + VALUE_REGISTERS + stackArgs + 8);
+        frame = (frame + 15) & ~15;
+
+        // Registradores vivos após cada instrução (código linear: uma varredura para trás)
+        std::vector<std::set<int>> liveAfter(n);
+        std::set<int> live;
+        auto registerOf = [](const std::string& name) {
+            return !name.empty() && name[0] == 'r' && !isNumber(name) ? std::stoi(name.substr(1)) : -1;
+        };
+        for (size_t i = n; i-- > 0;) {
+            liveAfter[i] = live;
+            int def = registerOf(func.body[i].result);
+            if (def >= 0) live.erase(def);
+            for (const auto& use : instructionUses(func.body[i])) {
+                int reg = registerOf(use);
+                if (reg >= 0) live.insert(reg);
+            }
+        }
+
+        out.beginFunction(func.name);
+        if (!frameless) out.prologue(frame);
+        if (values.at(func.name) > 1) out.store(memory(RBP, valuesSlot), RDI);
+
+        bool returned = false;
+        for (size_t i = 0; i < n; i++) {
+            const ThreeAddressCode& instr = func.body[i];
+            if (instr.op == "RETURN") {
+                ret(splitArgs(instr.arg1));
+                returned = true;
+                break;
+            }
+
+            Operand dst = operand(instr.result);
+            std::set<int> saved = liveAfter[i];
+            if (dst.kind == Operand::REGISTER) saved.erase(dst.reg);
+
+            if (isCopyOp(instr.op)) {
+                move(dst, operand(instr.arg1));
+            } else if (instr.op == "+" || instr.op == "*") {
+                arithmetic(instr.op == "+" ? Sse::ADD : Sse::MUL, true, dst, operand(instr.arg1), operand(instr.arg2));
+            } else if (instr.op == "-" || instr.op == "/") {
+                arithmetic(instr.op == "-" ? Sse::SUB : Sse::DIV, false, dst, operand(instr.arg1), operand(instr.arg2));
+            } else if (instr.op == "^") {
+                library(Library::POW, dst, {operand(instr.arg1), operand(instr.arg2)}, saved);
+            } else if (instr.op == "SQRT") {
+                int target = dst.kind == Operand::REGISTER ? dst.reg : TEMP;
+                out.sse(Sse::SQRT, target, operand(instr.arg1));
+                if (dst.kind != Operand::REGISTER) move(dst, xmm(TEMP));
+            } else if (instr.op == "LOG") {
+                library(Library::LOG, dst, {operand(instr.arg1)}, saved);
+            } else if (isFusedOp(instr.op)) {
+                Operand x = operand(instr.arg1), y = operand(instr.arg2), z = operand(instr.arg3);
+                if (fma3) {
+                    fused(instr.op, dst, x, y, z);
+                } else {
+                    // fma(x, y, z), fma(x, y, -z), fma(-x, y, z): o sinal é trocado
+                    // nos bits do operando, em uma posição de passagem
+                    std::vector<Operand> args = {x, y, z};
+                    if (instr.op != "FMA") {
+                        int negated = instr.op == "FMS" ? 2 : 0;
+                        Operand flipped = staging(3);
+                        move(flipped, args[negated]);
+                        out.load(RAX, flipped);
+                        out.flipSign(RAX);
+                        out.store(flipped, RAX);
+                        args[negated] = flipped;
+                    }
+                    library(Library::FMA, dst, args, saved);
+                }
+            } else if (instr.op == "CALL") {
+                call(instr.arg1, splitArgs(instr.arg2), dst);
+            }
+        }
+
+        // Função sem RETURN retorna 0
+        if (!returned) ret(std::vector<std::string>(1, "0"));
+        out.endFunction();
+    }
+};
+
+} // namespace
+
+void lowerFunction(const IRFunction& func, const std::unordered_map<std::string, int>& values, bool fma3,
+                   Emitter& out) {
+    FunctionLowering lowering(func, values, fma3, out);
+    lowering.translate();
+}
+
+} // namespace x86
@@ -0,0 +1,84 @@
+#ifndef LOWERING_H
+#define LOWERING_H
+
+#include "ir.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Tradução do código intermediário (já alocado em registradores XMM) para
+// x86-64 com a convenção System V, compartilhada pelo JIT e pelo backend de
+// assembly. As decisões de quadro e de passagem de argumentos ficam aqui; cada
+// backend implementa Emitter e só escolhe a forma da saída: bytes de código de
+// máquina (jit.cpp) ou texto AT&T (asmbackend.cpp).
+namespace x86 {
+
+// Registradores XMM que guardam valores (XMM0-XMM13); XMM14 e XMM15 são
+// temporários da tradução
+const int VALUE_REGISTERS = 14;
+const int TEMP = 15;
+const int TEMP2 = 14;
+
+// Registradores de uso geral usados pelo código gerado
+const int RAX = 0, RCX = 1, RSP = 4, RBP = 5, RDI = 7;
+
+// Operando após a alocação: registrador XMM (rN), memória [base + disp] (sN e
+// aN relativos a RBP, posições de passagem relativas a RSP, o vetor de valores
+// retornados em RCX) ou literal
+struct Operand {
+    enum Kind { REGISTER, MEMORY, CONSTANT } kind;
+    int reg;                 // REGISTER: XMM; MEMORY: registrador base
+    int32_t disp;
+    double value;
+
+    Operand() : kind(CONSTANT), reg(0), disp(0), value(0.0) {}
+};
+
+Operand xmm(int reg);
+Operand memory(int base, int32_t disp);
+
+// Operações SSE2 escalares "op origem, xmm"
+enum class Sse { MOVSD, MOVAPD, ADD, SUB, MUL, DIV, SQRT };
+
+// Funções da libm chamadas pelo código gerado
+enum class Library { POW, LOG, FMA };
+
+// Saída da tradução: uma chamada por instrução de máquina
+class Emitter {
+public:
+    virtual ~Emitter() {}
+
+    virtual void beginFunction(const std::string& name) = 0;
+    virtual void endFunction() = 0;
+    // push rbp; mov rbp, rsp; sub rsp, frame / [leave;] ret
+    virtual void prologue(int32_t frame) = 0;
+    virtual void epilogue(bool frame) = 0;
+
+    virtual void sse(Sse op, int reg, const Operand& src) = 0;             // op src, xmm(reg)
+    virtual void storeDouble(const Operand& dst, int reg) = 0;             // movsd xmm(reg), [dst]
+    // FMA3 (VFMADD231SD, VFMSUB231SD, VFNMADD231SD): xmm(dst) = xmm(src1) * src2 +/- xmm(dst)
+    virtual void fused(const std::string& op, int dst, int src1, const Operand& src2) = 0;
+
+    virtual void load(int reg, const Operand& src) = 0;                    // mov r64, [src] ou os bits do literal
+    virtual void store(const Operand& dst, int reg) = 0;                   // mov [dst], r64
+    virtual void flipSign(int reg) = 0;                                    // btc r64, 63
+    virtual void clear(int reg) = 0;                                       // xor r32, r32
+
+    // Desvio para o rótulo de retorno da função (um por função) se reg for zero
+    virtual void jumpIfZero(int reg) = 0;
+    virtual void returnLabel() = 0;
+
+    virtual void callFunction(const std::string& name) = 0;
+    virtual void callLibrary(Library function) = 0;
+};
+
+// Traduz uma função. values: valores retornados por função do módulo (as de
+// gradiente retornam vários e recebem, depois dos argumentos, um double* em
+// RDI, que pode ser NULL); fma3: FMA/FMS/FNMA com as instruções FMA3 em vez de
+// chamar fma da libm
+void lowerFunction(const IRFunction& func, const std::unordered_map<std::string, int>& values, bool fma3,
+                   Emitter& out);
+
+} // namespace x86
+
+#endif // LOWERING_H
@@ -1,22 +1,86 @@
 #include "compiler.h"
+#include "ir.h"
 #include "utils.h"
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 bool hasNetoExtension(const std::string& filename) {
     if (filename.length() < 5) return false;
     return filename.substr(filename.length() - 5) == ".neto";
 }
 
+bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
 int main(int argc, char* argv[]) {
-    bool verbose = false;
+    CompilerOptions options;
     std::string filename;
+    std::string runFunction;
+    std::vector<double> runArgs;
+    bool checkJIT = false;               // --check-jit: compara JIT e máquina virtual
     
     // Processar argumentos
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "-v" || arg == "--verbose") {
-            verbose = true;
+            options.verbose = true;
+        } else if (arg == "-O" || arg == "--optimize") {
+            options.optimize = true;
+        } else if (arg == "-ffast-math") {
+            options.optimizer.fastMath = true;
+        } else if (arg == "-ffp-contract=fast" || arg == "-ffp-contract=on") {
+            options.optimizer.fpContract = true;
+        } else if (arg == "-ffp-contract=off") {
+            options.optimizer.fpContract = false;
+        } else if (arg.rfind("--entry=", 0) == 0) {
+            for (const auto& name : splitArgs(arg.substr(8))) options.entries.push_back(name);
+        } else if (arg.rfind("--grad=", 0) == 0) {
+            for (const auto& name : splitArgs(arg.substr(7))) options.gradients.push_back(name);
+        } else if (arg == "--egraph") {
+            options.optimizer.egraph = true;
+        } else if (arg.rfind("--egraph-nodes=", 0) == 0) {
+            options.optimizer.egraphOptions.nodeLimit = std::atoi(arg.c_str() + 15);
+        } else if (arg.rfind("--inline-threshold=", 0) == 0) {
+            options.optimizer.inlineThreshold = std::atoi(arg.c_str() + 19);
+        } else if (arg.rfind("--emit=", 0) == 0) {
+            options.emit = arg.substr(7);
+        } else if (arg.rfind("--registers=", 0) == 0) {
+            options.regalloc.registers = std::atoi(arg.c_str() + 12);
+        } else if (arg.rfind("--call-conv=", 0) == 0) {
+            options.regalloc.convention = arg.substr(12);
+        } else if (arg == "--dispatch=switch") {
+            options.vm.threaded = false;
+        } else if (arg == "--dispatch=threaded") {
+            options.vm.threaded = VM_THREADED_DISPATCH;
+        } else if (arg == "--no-superinstructions") {
+            options.vm.superinstructions = false;
+        } else if (arg == "--jit") {
+            options.jit = true;
+        } else if (arg == "--native") {
+            options.native = true;
+        } else if (arg == "--shared") {
+            options.native = true;
+            options.shared = true;
+        } else if (arg == "-o" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg == "--check-jit") {
+            checkJIT = true;
+        } else if (arg == "--run" && i + 1 < argc) {
+            // --run f [args...]: os argumentos numéricos seguintes são passados a f
+            runFunction = argv[++i];
+            double value;
+            while (i + 1 < argc && parseNumber(argv[i + 1], value)) {
+                runArgs.push_back(value);
+                i++;
+            }
+        } else if (arg == "--bench" && i + 1 < argc) {
+            options.benchIterations = std::atoi(argv[++i]);
         } else {
             filename = arg;
         }
@@ -24,7 +88,12 @@ int main(int argc, char* argv[]) {
     
     // Verificar se arquivo foi fornecido
     if (filename.empty()) {
-        std::cerr << logError("[ERROR] Uso correto: " + std::string(argv[0]) + " [-v] arquivo.neto") << std::endl;
+        std::cerr << logError("[ERROR] Uso correto: " + std::string(argv[0]) + " [-v] [-O] [-ffast-math] [-ffp-contract=fast|off] [--egraph [--egraph-nodes=N]] [--inline-threshold=N] [--entry=f,g] [--grad=f,g] [--emit=regs [--registers=N] [--call-conv=sysv|win64|vm]] [--emit=c|asm] [--native|--shared [-o saida.o|saida.so]] [--run f args... [--bench N] [--dispatch=switch|threaded] [--no-superinstructions] [--jit]] [--check-jit] arquivo.neto") << std::endl;
+        return 1;
+    }
+    
+    if (!options.emit.empty() && options.emit != "regs" && options.emit != "c" && options.emit != "asm") {
+        std::cerr << logError("[ERROR] Formato de saída desconhecido '" + options.emit + "' (use --emit=regs, --emit=c ou --emit=asm)") << std::endl;
         return 1;
     }
     
@@ -35,9 +104,19 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    Compiler compiler(verbose);
-    compiler.compileFile(filename);
+    Compiler compiler(options);
+    bool ok = compiler.compileFile(filename);
+    
+    // Código de saída diferente de zero quando a compilação falha, o JIT
+    // diverge da máquina virtual ou a execução falha (make test depende disso)
+    if (ok && checkJIT) {
+        ok = compiler.checkJIT();
+    }
+    
+    if (ok && !runFunction.empty()) {
+        ok = compiler.run(runFunction, runArgs);
+    }
     
-    return 0;
+    return ok ? 0 : 1;
 }
 
@@ -0,0 +1,248 @@
+#include "neto.h"
+#include "jit.h"
+#include "vm.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace neto {
+
+// Estado compartilhado entre um Module e as funções obtidas dele
+struct ModuleState {
+    Backend backend;
+    bool ok;
+    std::vector<Diagnostic> diagnostics;
+    std::vector<ThreeAddressCode> code;
+    IRModule module;
+    std::vector<std::string> names;      // Funções na ordem do módulo (os índices da VM e do JIT)
+    std::vector<int> arities;
+    std::unordered_map<std::string, int> index;
+    std::unique_ptr<VM> vm;
+    std::unique_ptr<JIT> jit;
+    std::vector<JIT::EntryPoint> entries;
+    std::string error;                   // Último erro de execução
+
+    // Execução em camadas: contadores de chamadas e pontos de entrada trocados
+    // pela thread de tradução (nullptr: a função ainda executa na máquina virtual)
+    long threshold;
+    std::vector<long> calls;
+    std::unique_ptr<std::atomic<JIT::EntryPoint>[]> tiers;
+    std::vector<std::unique_ptr<JIT>> tierCode;     // Código traduzido (vive até o fim do módulo)
+    std::deque<int> queue;                          // Funções à espera da tradução
+    int pending;                                    // ... e em tradução
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::thread worker;
+
+    ModuleState() : backend(Backend::INTERPRETER), ok(false), threshold(0), pending(0), stopping(false) {}
+
+    ~ModuleState() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+    // Chamada na thread que executa a função: enfileira a tradução (a thread
+    // de fundo só é criada quando alguma função atinge o limite)
+    void promote(int function) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(function);
+            pending++;
+            if (!worker.joinable()) worker = std::thread(&ModuleState::translate, this);
+        }
+        wake.notify_one();
+    }
+
+    // Thread de fundo: traduz de uma vez as funções na fila, com as funções que
+    // elas chamam (o JIT resolve as chamadas dentro do próprio módulo), e publica
+    // os pontos de entrada. Juntar a fila em um só módulo mantém o código das
+    // funções quentes em poucas páginas
+    void translate() {
+        for (;;) {
+            std::vector<int> order;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (stopping) return;
+                order.assign(queue.begin(), queue.end());
+                queue.clear();
+            }
+
+            // As funções da fila ocupam as primeiras posições do módulo traduzido
+            size_t roots = order.size();
+            std::vector<char> seen(names.size(), 0);
+            for (int function : order) seen[function] = 1;
+            IRModule reachable;
+            for (size_t i = 0; i < order.size(); i++) {
+                const IRFunction& func = module.functions[order[i]];
+                reachable.functions.push_back(func);
+                for (const auto& instr : func.body) {
+                    if (instr.op != "CALL") continue;
+                    auto callee = index.find(instr.arg1);
+                    if (callee == index.end() || seen[callee->second]) continue;
+                    seen[callee->second] = 1;
+                    order.push_back(callee->second);
+                }
+            }
+
+            // Funções com erro (recursivas, por exemplo) continuam na máquina
+            // virtual, que informa o erro
+            std::unique_ptr<JIT> native(new JIT(reachable));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < roots; i++) {
+                JIT::EntryPoint entry = native->entry(i);
+                if (entry) tiers[order[i]].store(entry, std::memory_order_release);
+            }
+            tierCode.push_back(std::move(native));
+            pending -= roots;
+            if (pending == 0) idle.notify_all();
+        }
+    }
+};
+
+Module compile(const std::string& source, const Options& options) {
+    auto state = std::make_shared<ModuleState>();
+    state->backend = options.backend;
+
+    CompilerOptions compilerOptions = options.compiler;
+    compilerOptions.verbose = false;
+    compilerOptions.quiet = true;
+    compilerOptions.emit = "";
+    Compiler compiler(compilerOptions);
+    state->ok = compiler.compile(source);
+    state->diagnostics = compiler.getDiagnostics();
+    if (!state->ok) return Module(state);
+
+    state->code = compiler.getCode();
+    state->module = buildModule(state->code);
+    const IRModule& module = state->module;
+    for (size_t i = 0; i < module.functions.size(); i++) {
+        state->names.push_back(module.functions[i].name);
+        state->arities.push_back(module.functions[i].params.size());
+        state->index[module.functions[i].name] = i;
+    }
+    if (options.backend == Backend::JIT) {
+        state->jit.reset(new JIT(module));
+        for (size_t i = 0; i < module.functions.size(); i++) state->entries.push_back(state->jit->entry(i));
+    } else {
+        state->vm.reset(new VM(module, compilerOptions.vm));
+    }
+    if (options.backend == Backend::TIERED) {
+        state->threshold = std::max(options.tierThreshold, 1L);
+        state->calls.assign(module.functions.size(), 0);
+        state->tiers.reset(new std::atomic<JIT::EntryPoint>[module.functions.size()]);
+        for (size_t i = 0; i < module.functions.size(); i++) state->tiers[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return Module(state);
+}
+
+bool Module::ok() const {
+    return state->ok;
+}
+
+const std::vector<Diagnostic>& Module::diagnostics() const {
+    return state->diagnostics;
+}
+
+Function Module::function(const std::string& name) const {
+    auto it = state->index.find(name);
+    return it == state->index.end() ? Function() : Function(state, it->second);
+}
+
+std::vector<std::string> Module::functions() const {
+    return state->names;
+}
+
+Backend Module::backend() const {
+    return state->backend;
+}
+
+int Module::nativeFunctions() const {
+    int count = 0;
+    if (state->backend == Backend::JIT) {
+        for (auto entry : state->entries) count += entry != nullptr;
+    } else if (state->backend == Backend::TIERED) {
+        for (size_t i = 0; i < state->names.size(); i++) count += state->tiers[i].load(std::memory_order_acquire) != nullptr;
+    }
+    return count;
+}
+
+void Module::wait() const {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle.wait(lock, [this] { return state->pending == 0; });
+}
+
+const std::vector<ThreeAddressCode>& Module::code() const {
+    return state->code;
+}
+
+std::string Function::name() const {
+    return *this ? state->names[index] : "";
+}
+
+int Function::arity() const {
+    return *this ? state->arities[index] : 0;
+}
+
+double Function::call(const double* args, size_t count) const {
+    const double failed = std::numeric_limits<double>::quiet_NaN();
+    if (!*this) return failed;
+    ModuleState& module = *state;
+    if (static_cast<int>(count) != module.arities[index]) {
+        module.error = "função '" + module.names[index] + "' espera " + std::to_string(module.arities[index]) +
+                       " argumento(s), mas " + std::to_string(count) + " foi(ram) fornecido(s)";
+        return failed;
+    }
+
+    // JIT: chamada direta ao ponto de entrada nativo
+    if (module.backend == Backend::JIT) {
+        JIT::EntryPoint entry = module.entries[index];
+        if (entry) return entry(args);
+        double result;
+        module.jit->call(index, args, result);
+        module.error = module.jit->getError();
+        return failed;
+    }
+
+    // Em camadas: código nativo se já traduzido; senão, máquina virtual e contador
+    if (module.backend == Backend::TIERED) {
+        JIT::EntryPoint entry = module.tiers[index].load(std::memory_order_acquire);
+        if (entry) return entry(args);
+        if (++module.calls[index] == module.threshold) module.promote(index);
+    }
+
+    double result;
+    if (!module.vm->call(index, args, result)) {
+        module.error = module.vm->getError();
+        return failed;
+    }
+    return result;
+}
+
+bool Function::call(const std::vector<double>& args, std::vector<double>& results) const {
+    results.clear();
+    if (!*this) return false;
+    ModuleState& module = *state;
+    bool ok = module.backend == Backend::JIT ? module.jit->call(module.names[index], args, results)
+                                             : module.vm->call(module.names[index], args, results);
+    if (!ok) module.error = module.backend == Backend::JIT ? module.jit->getError() : module.vm->getError();
+    return ok;
+}
+
+std::string Function::getError() const {
+    return state ? state->error : "função não existe";
+}
+
+} // namespace neto
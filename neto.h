@@ -0,0 +1,94 @@
+#ifndef NETO_H
+#define NETO_H
+
+#include "compiler.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Interface da biblioteca libneto para programas que compilam um arquivo .neto
+// uma vez e chamam suas funções muitas vezes:
+//
+//     neto::Module m = neto::compile(source);
+//     neto::Function media = m.function("media");
+//     double r = media(1.0, 2.0);
+//
+// Nada é impresso: os erros de compilação ficam em Module::diagnostics e os de
+// execução em Function::getError. Um Module (e as funções obtidas dele) não deve
+// ser chamado por mais de uma thread ao mesmo tempo, e o parser não é reentrante:
+// compilações em threads diferentes precisam ser serializadas.
+namespace neto {
+
+// Execução das funções: máquina virtual de registradores, código nativo do JIT
+// (todas as funções traduzidas ao compilar) ou em camadas: cada função começa
+// na máquina virtual com um contador de chamadas e, ao atingir tierThreshold,
+// é traduzida pelo JIT em uma thread de fundo; o ponto de entrada da função é
+// então trocado atomicamente e as chamadas seguintes vão direto ao código nativo
+enum class Backend { INTERPRETER, JIT, TIERED };
+
+struct Options {
+    Backend backend;
+    long tierThreshold;          // TIERED: chamadas na máquina virtual antes da tradução
+    CompilerOptions compiler;    // -O, -ffast-math, --grad=f, --entry=f, ... (verbose e quiet são ignorados)
+
+    Options() : backend(Backend::INTERPRETER), tierThreshold(1000) {}
+};
+
+struct ModuleState;
+
+class Function {
+private:
+    std::shared_ptr<ModuleState> state;
+    int index;
+
+public:
+    Function() : index(-1) {}
+    Function(const std::shared_ptr<ModuleState>& module, int function) : state(module), index(function) {}
+
+    // false se a função não existe no módulo
+    explicit operator bool() const { return state && index >= 0; }
+    std::string name() const;
+    int arity() const;
+
+    // Primeiro valor retornado (NaN em erro de execução, com a mensagem em getError)
+    double call(const double* args, size_t count) const;
+    template <typename... Args>
+    double operator()(Args... args) const {
+        const double values[] = {static_cast<double>(args)..., 0.0};
+        return call(values, sizeof...(Args));
+    }
+    // Todos os valores retornados (funções de gradiente: valor e derivadas parciais)
+    bool call(const std::vector<double>& args, std::vector<double>& results) const;
+
+    std::string getError() const;
+};
+
+class Module {
+private:
+    std::shared_ptr<ModuleState> state;
+
+public:
+    explicit Module(const std::shared_ptr<ModuleState>& module) : state(module) {}
+
+    // false se a compilação falhou (os erros estão em diagnostics)
+    bool ok() const;
+    explicit operator bool() const { return ok(); }
+    const std::vector<Diagnostic>& diagnostics() const;
+
+    // Função compilada (Function vazia se não existe)
+    Function function(const std::string& name) const;
+    std::vector<std::string> functions() const;
+    Backend backend() const;
+    // Funções com código nativo (TIERED: as já traduzidas em segundo plano)
+    int nativeFunctions() const;
+    // TIERED: espera a tradução das funções que já atingiram o limite
+    void wait() const;
+    // Código intermediário final (após a otimização)
+    const std::vector<ThreeAddressCode>& code() const;
+};
+
+Module compile(const std::string& source, const Options& options = Options());
+
+} // namespace neto
+
+#endif // NETO_H
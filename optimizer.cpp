@@ -0,0 +1,920 @@
+#include "optimizer.h"
+#include "ipo.h"
+#include "liveness.h"
+#include "ssa.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <sstream>
+
+// ==================== PASSES LOCAIS ====================
+
+bool foldInstruction(ThreeAddressCode& instr) {
+    double value;
+    if (isBinaryOp(instr.op) && isNumber(instr.arg1) && isNumber(instr.arg2)) {
+        value = evaluateBinary(instr.op, toNumber(instr.arg1), toNumber(instr.arg2));
+    } else if (isUnaryOp(instr.op) && isNumber(instr.arg1)) {
+        value = evaluateUnary(instr.op, toNumber(instr.arg1));
+    } else if (isFusedOp(instr.op) && isNumber(instr.arg1) && isNumber(instr.arg2) && isNumber(instr.arg3)) {
+        value = evaluateFused(instr.op, toNumber(instr.arg1), toNumber(instr.arg2), toNumber(instr.arg3));
+    } else {
+        return false;
+    }
+
+    // Resultados não finitos (ex.: divisão por zero) ficam para a execução
+    if (!std::isfinite(value)) return false;
+    instr = ThreeAddressCode(instr.result, "=", formatNumber(value));
+    return true;
+}
+
+int removeUnreachableCode(IRFunction& func) {
+    for (size_t i = 0; i < func.body.size(); i++) {
+        if (func.body[i].op == "RETURN") {
+            int removed = func.body.size() - (i + 1);
+            func.body.erase(func.body.begin() + i + 1, func.body.end());
+            return removed;
+        }
+    }
+    return 0;
+}
+
+int eliminateDeadCode(IRFunction& func) {
+    std::set<std::string> live;
+    std::vector<ThreeAddressCode> kept;
+    int removed = 0;
+
+    // Todas as operações são puras (inclusive CALL): uma definição que não
+    // está viva pode ser descartada sem alterar o resultado da função
+    for (auto it = func.body.rbegin(); it != func.body.rend(); ++it) {
+        const ThreeAddressCode& instr = *it;
+
+        if (instr.op != "RETURN") {
+            bool selfCopy = instr.op == "=" && instr.arg1 == instr.result;
+            if (selfCopy || live.find(instr.result) == live.end()) {
+                removed++;
+                continue;
+            }
+            live.erase(instr.result);
+        }
+
+        for (const auto& use : instructionUses(instr)) live.insert(use);
+        kept.push_back(instr);
+    }
+
+    func.body.assign(kept.rbegin(), kept.rend());
+    return removed;
+}
+
+// ==================== REDUÇÃO DE FORÇA DE POTÊNCIAS ====================
+
+namespace {
+
+// Maior expoente reescrito como cadeia de multiplicações
+const int MAX_CHAIN_EXPONENT = 128;
+
+bool searchChain(std::vector<int>& chain, int target, int limit) {
+    int last = chain.back();
+    if (last == target) return true;
+
+    int remaining = limit - static_cast<int>(chain.size() - 1);
+    if (remaining <= 0) return false;
+    // Poda: nem dobrando a cada passo seria possível alcançar o alvo
+    if ((static_cast<long>(last) << remaining) < target) return false;
+
+    for (int i = chain.size() - 1; i >= 0; i--) {
+        for (int j = i; j >= 0; j--) {
+            int next = chain[i] + chain[j];
+            if (next <= last || next > target) continue;
+            chain.push_back(next);
+            if (searchChain(chain, target, limit)) return true;
+            chain.pop_back();
+        }
+    }
+    return false;
+}
+
+// Cadeia de adição mínima para n (aprofundamento iterativo): cada elemento é a
+// soma de dois anteriores, e cada soma vira uma multiplicação de potências
+const std::vector<int>& additionChain(int n) {
+    static std::map<int, std::vector<int>> cache;
+    auto it = cache.find(n);
+    if (it != cache.end()) return it->second;
+
+    std::vector<int> chain;
+    for (int limit = 0; ; limit++) {
+        chain.assign(1, 1);
+        if (searchChain(chain, n, limit)) break;
+    }
+    return cache[n] = chain;
+}
+
+// Emite "result = base^n" (n >= 2) como multiplicações seguindo a cadeia
+void emitPowerChain(IRModule& module, const std::string& base, int n, const std::string& result,
+                    std::vector<ThreeAddressCode>& out) {
+    const std::vector<int>& chain = additionChain(n);
+    std::vector<std::string> names(1, base);
+
+    for (size_t k = 1; k < chain.size(); k++) {
+        std::string left, right;
+        for (size_t i = 0; i < k && left.empty(); i++) {
+            for (size_t j = 0; j <= i; j++) {
+                if (chain[i] + chain[j] == chain[k]) {
+                    left = names[i];
+                    right = names[j];
+                    break;
+                }
+            }
+        }
+        std::string target = k + 1 == chain.size() ? result : module.newTemp();
+        out.push_back(ThreeAddressCode(target, "*", left, right));
+        names.push_back(target);
+    }
+}
+
+} // namespace
+
+int reducePowers(IRFunction& func, IRModule& module, bool fastMath, OptimizerStats& stats) {
+    std::vector<ThreeAddressCode> body;
+    int reduced = 0;
+
+    for (const auto& instr : func.body) {
+        if (instr.op != "^" || !isNumber(instr.arg2)) {
+            body.push_back(instr);
+            continue;
+        }
+
+        double exponent = toNumber(instr.arg2);
+        const std::string& base = instr.arg1;
+        const std::string& result = instr.result;
+
+        if (exponent == 0.0) {
+            // pow(x, 0) é 1 para qualquer x, inclusive NaN
+            body.push_back(ThreeAddressCode(result, "=", "1"));
+        } else if (exponent == 1.0) {
+            body.push_back(ThreeAddressCode(result, "=", base));
+        } else if (fastMath && (exponent == 0.5 || exponent == -0.5)) {
+            // Difere de pow em -0 e -inf: apenas com -ffast-math
+            if (exponent == 0.5) {
+                body.push_back(ThreeAddressCode(result, "SQRT", base));
+            } else {
+                std::string root = module.newTemp();
+                body.push_back(ThreeAddressCode(root, "SQRT", base));
+                body.push_back(ThreeAddressCode(result, "/", "1", root));
+            }
+        } else if (exponent == std::floor(exponent) && std::fabs(exponent) <= MAX_CHAIN_EXPONENT) {
+            int n = static_cast<int>(std::fabs(exponent));
+            if (exponent > 0) {
+                emitPowerChain(module, base, n, result, body);
+            } else if (n == 1) {
+                body.push_back(ThreeAddressCode(result, "/", "1", base));
+            } else {
+                // Expoente negativo: recíproco da cadeia
+                std::string power = module.newTemp();
+                emitPowerChain(module, base, n, power, body);
+                body.push_back(ThreeAddressCode(result, "/", "1", power));
+            }
+        } else {
+            body.push_back(instr);
+            continue;
+        }
+
+        reduced++;
+    }
+
+    func.body = body;
+    stats.reducedPowers += reduced;
+    return reduced;
+}
+
+// ==================== FORMA DE HORNER ====================
+
+namespace {
+
+// Limites da expansão de uma expressão em polinômio
+const size_t MAX_MONOMIALS = 64;
+const size_t MAX_MONOMIAL_DEGREE = 32;
+const int MAX_EXPANDED_EXPONENT = 8;
+
+// Polinômio em várias folhas: monômio (folhas ordenadas) -> coeficiente
+typedef std::map<std::vector<std::string>, double> Polynomial;
+
+class PolynomialExpander {
+private:
+    const std::vector<ThreeAddressCode>& body;
+    std::map<std::string, std::vector<int>> defPositions;
+    int rootPos;
+    std::map<int, Polynomial> memo;
+    std::set<int> visited;
+
+    // Última definição de name antes da posição pos (-1: parâmetro ou indefinido)
+    int defAt(const std::string& name, int pos) const {
+        auto it = defPositions.find(name);
+        if (it == defPositions.end()) return -1;
+        auto bound = std::lower_bound(it->second.begin(), it->second.end(), pos);
+        if (bound == it->second.begin()) return -1;
+        return *(bound - 1);
+    }
+
+    static bool add(Polynomial& target, const Polynomial& other, double sign) {
+        for (const auto& term : other) {
+            target[term.first] += sign * term.second;
+        }
+        return target.size() <= MAX_MONOMIALS;
+    }
+
+    static bool multiply(const Polynomial& a, const Polynomial& b, Polynomial& result) {
+        result.clear();
+        for (const auto& left : a) {
+            for (const auto& right : b) {
+                std::vector<std::string> monomial = left.first;
+                monomial.insert(monomial.end(), right.first.begin(), right.first.end());
+                if (monomial.size() > MAX_MONOMIAL_DEGREE) return false;
+                std::sort(monomial.begin(), monomial.end());
+                result[monomial] += left.second * right.second;
+            }
+        }
+        return result.size() <= MAX_MONOMIALS;
+    }
+
+    bool leaf(const std::string& name, int usePos, Polynomial& result) {
+        // A folha só pode ser usada se tiver o mesmo valor na posição da raiz
+        if (defAt(name, usePos) != defAt(name, rootPos)) return false;
+        result.clear();
+        result[std::vector<std::string>(1, name)] = 1.0;
+        return true;
+    }
+
+public:
+    PolynomialExpander(const std::vector<ThreeAddressCode>& code, int root)
+        : body(code), rootPos(root) {
+        for (int i = 0; i < static_cast<int>(body.size()); i++) {
+            if (!body[i].result.empty()) defPositions[body[i].result].push_back(i);
+        }
+    }
+
+    // Posições das instruções percorridas pela expansão
+    const std::set<int>& expanded() const {
+        return visited;
+    }
+
+    // Instruções aritméticas percorridas (custo da expressão original)
+    int originalCost() const {
+        int cost = 0;
+        for (int index : visited) {
+            const std::string& op = body[index].op;
+            if (op == "^") cost += 3;
+            else if (op != "=") cost++;
+        }
+        return cost;
+    }
+
+    bool expandOperand(const std::string& operand, int usePos, Polynomial& result) {
+        if (isNumber(operand)) {
+            result.clear();
+            result[std::vector<std::string>()] = toNumber(operand);
+            return true;
+        }
+
+        int def = defAt(operand, usePos);
+        if (def < 0) return leaf(operand, usePos, result);
+
+        const ThreeAddressCode& instr = body[def];
+        if (!isBinaryOp(instr.op) && instr.op != "=") return leaf(operand, usePos, result);
+
+        auto cached = memo.find(def);
+        if (cached != memo.end()) {
+            result = cached->second;
+            return true;
+        }
+
+        if (!expandInstruction(def, result)) {
+            // Subexpressão não polinomial: o próprio nome vira uma folha
+            return leaf(operand, usePos, result);
+        }
+        memo[def] = result;
+        return true;
+    }
+
+    bool expandInstruction(int pos, Polynomial& result) {
+        const ThreeAddressCode& instr = body[pos];
+        Polynomial left, right;
+
+        if (instr.op == "=") {
+            if (!expandOperand(instr.arg1, pos, result)) return false;
+            visited.insert(pos);
+            return true;
+        }
+
+        if (instr.op == "/" || instr.op == "^") {
+            if (!isNumber(instr.arg2)) return false;
+            double value = toNumber(instr.arg2);
+            if (instr.op == "/" && value == 0.0) return false;
+            if (instr.op == "^" && (value != std::floor(value) || value < 0 || value > MAX_EXPANDED_EXPONENT)) {
+                return false;
+            }
+        }
+
+        if (!expandOperand(instr.arg1, pos, left)) return false;
+
+        if (instr.op == "/") {
+            for (auto& term : left) term.second /= toNumber(instr.arg2);
+            result = left;
+        } else if (instr.op == "^") {
+            int exponent = static_cast<int>(toNumber(instr.arg2));
+            result.clear();
+            result[std::vector<std::string>()] = 1.0;
+            for (int i = 0; i < exponent; i++) {
+                Polynomial product;
+                if (!multiply(result, left, product)) return false;
+                result = product;
+            }
+        } else {
+            if (!expandOperand(instr.arg2, pos, right)) return false;
+            if (instr.op == "*") {
+                if (!multiply(left, right, result)) return false;
+            } else {
+                result = left;
+                if (!add(result, right, instr.op == "+" ? 1.0 : -1.0)) return false;
+            }
+        }
+
+        visited.insert(pos);
+        return true;
+    }
+};
+
+// Coeficiente de um grau: soma de termos (constante * folhas)
+typedef std::vector<std::pair<double, std::vector<std::string>>> Coefficient;
+
+// Emite o valor absoluto de um termo; retorna o operando com o resultado
+std::string emitProduct(IRModule& module, double constant, const std::vector<std::string>& factors,
+                        std::vector<ThreeAddressCode>& out) {
+    if (factors.empty()) return formatNumber(constant);
+
+    std::string value = factors[0];
+    for (size_t i = 1; i < factors.size(); i++) {
+        std::string temp = module.newTemp();
+        out.push_back(ThreeAddressCode(temp, "*", value, factors[i]));
+        value = temp;
+    }
+    if (constant != 1.0) {
+        std::string temp = module.newTemp();
+        out.push_back(ThreeAddressCode(temp, "*", formatNumber(constant), value));
+        value = temp;
+    }
+    return value;
+}
+
+// Combina acc com um coeficiente: acc + c (ou acc - |c| para termos negativos)
+std::string emitAccumulate(IRModule& module, std::string acc, const Coefficient& coefficient,
+                           std::vector<ThreeAddressCode>& out) {
+    for (const auto& term : coefficient) {
+        bool negative = term.first < 0;
+        std::string value = emitProduct(module, std::fabs(term.first), term.second, out);
+        if (acc.empty()) {
+            if (negative) {
+                std::string temp = module.newTemp();
+                out.push_back(ThreeAddressCode(temp, "-", "0", value));
+                value = temp;
+            }
+            acc = value;
+            continue;
+        }
+        std::string temp = module.newTemp();
+        out.push_back(ThreeAddressCode(temp, negative ? "-" : "+", acc, value));
+        acc = temp;
+    }
+    return acc;
+}
+
+// Tenta reescrever a soma definida em body[root] na forma de Horner; covered
+// recebe as posições das instruções absorvidas pela reescrita
+bool emitHorner(IRModule& module, const std::vector<ThreeAddressCode>& body, int root,
+                std::vector<ThreeAddressCode>& out, std::set<int>& covered) {
+    PolynomialExpander expander(body, root);
+    Polynomial poly;
+    if (!expander.expandInstruction(root, poly)) return false;
+
+    // Variável: a folha com o maior expoente em algum monômio
+    std::string variable;
+    int degree = 0;
+    for (const auto& term : poly) {
+        if (term.second == 0.0) continue;
+        const std::vector<std::string>& monomial = term.first;
+        for (size_t i = 0; i < monomial.size(); ) {
+            size_t j = i;
+            while (j < monomial.size() && monomial[j] == monomial[i]) j++;
+            if (static_cast<int>(j - i) > degree) {
+                degree = j - i;
+                variable = monomial[i];
+            }
+            i = j;
+        }
+    }
+    if (degree < 2) return false;
+
+    std::vector<Coefficient> coefficients(degree + 1);
+    for (const auto& term : poly) {
+        if (term.second == 0.0) continue;
+        std::vector<std::string> factors;
+        int power = 0;
+        for (const auto& name : term.first) {
+            if (name == variable) power++;
+            else factors.push_back(name);
+        }
+        coefficients[power].push_back(std::make_pair(term.second, factors));
+    }
+
+    int nonZero = 0;
+    for (const auto& coefficient : coefficients) {
+        if (!coefficient.empty()) nonZero++;
+    }
+    if (nonZero < 2) return false;
+
+    // ((c_n * x + c_n-1) * x + ...) * x + c_0
+    std::vector<ThreeAddressCode> code;
+    std::string acc = emitAccumulate(module, "", coefficients[degree], code);
+    for (int d = degree - 1; d >= 0; d--) {
+        std::string temp = module.newTemp();
+        code.push_back(ThreeAddressCode(temp, "*", acc, variable));
+        acc = emitAccumulate(module, temp, coefficients[d], code);
+    }
+
+    int cost = 0;
+    for (const auto& instr : code) {
+        if (instr.op != "=") cost++;
+    }
+    if (cost >= expander.originalCost()) return false;
+
+    // O último valor calculado passa a ser o resultado da raiz
+    if (!code.empty() && code.back().result == acc) {
+        code.back().result = body[root].result;
+    } else {
+        code.push_back(ThreeAddressCode(body[root].result, "=", acc));
+    }
+    out.insert(out.end(), code.begin(), code.end());
+    covered.insert(expander.expanded().begin(), expander.expanded().end());
+    return true;
+}
+
+} // namespace
+
+int rewriteHorner(IRFunction& func, IRModule& module, OptimizerStats& stats) {
+    std::map<std::string, int> uses;
+    for (const auto& instr : func.body) {
+        for (const auto& use : instructionUses(instr)) uses[use]++;
+    }
+
+    // Raízes da última para a primeira: uma soma interna de um polinômio já
+    // reescrito (temporário lido apenas dentro dele) não é expandida de novo
+    std::map<int, std::vector<ThreeAddressCode>> rewrites;
+    std::set<int> covered;
+    for (int i = static_cast<int>(func.body.size()) - 1; i >= 0; i--) {
+        const ThreeAddressCode& instr = func.body[i];
+        if (instr.op != "+" && instr.op != "-") continue;
+        if (covered.count(i) && isTempName(instr.result) && uses[instr.result] == 1) continue;
+        std::vector<ThreeAddressCode> code;
+        if (emitHorner(module, func.body, i, code, covered)) rewrites[i] = code;
+    }
+    if (rewrites.empty()) return 0;
+
+    // As subexpressões substituídas ficam mortas e são removidas pelo DCE
+    std::vector<ThreeAddressCode> body;
+    for (int i = 0; i < static_cast<int>(func.body.size()); i++) {
+        auto it = rewrites.find(i);
+        if (it == rewrites.end()) body.push_back(func.body[i]);
+        else body.insert(body.end(), it->second.begin(), it->second.end());
+    }
+    func.body = body;
+    int rewritten = rewrites.size();
+    stats.hornerRewrites += rewritten;
+    return rewritten;
+}
+
+// ==================== REASSOCIAÇÃO ====================
+
+namespace {
+
+// Classe associativa da operação: soma/subtração ou multiplicação
+char chainClass(const std::string& op) {
+    if (op == "+" || op == "-") return '+';
+    if (op == "*") return '*';
+    return 0;
+}
+
+class ChainCollector {
+private:
+    const std::vector<ThreeAddressCode>& body;
+    const std::map<std::string, int>& uses;
+    std::map<std::string, std::vector<int>> defPositions;
+    int rootPos;
+    char kind;
+
+    int defAt(const std::string& name, int pos) const {
+        auto it = defPositions.find(name);
+        if (it == defPositions.end()) return -1;
+        auto bound = std::lower_bound(it->second.begin(), it->second.end(), pos);
+        if (bound == it->second.begin()) return -1;
+        return *(bound - 1);
+    }
+
+public:
+    // Folhas da cadeia com sinal (true = subtraída)
+    std::vector<std::pair<std::string, bool>> leaves;
+
+    ChainCollector(const std::vector<ThreeAddressCode>& code, const std::map<std::string, int>& useCounts,
+                   int root)
+        : body(code), uses(useCounts), rootPos(root), kind(chainClass(code[root].op)) {
+        for (int i = 0; i < static_cast<int>(body.size()); i++) {
+            if (!body[i].result.empty()) defPositions[body[i].result].push_back(i);
+        }
+    }
+
+    // Profundidade da árvore original a partir de pos
+    int collect(int pos, bool negated) {
+        const ThreeAddressCode& instr = body[pos];
+        int left = collectOperand(instr.arg1, pos, negated);
+        int right = collectOperand(instr.arg2, pos, instr.op == "-" ? !negated : negated);
+        return std::max(left, right) + 1;
+    }
+
+    int collectOperand(const std::string& operand, int usePos, bool negated) {
+        int def = isNumber(operand) ? -1 : defAt(operand, usePos);
+        auto count = uses.find(operand);
+
+        // Desce apenas em temporários lidos uma vez, da mesma classe, cujas
+        // folhas ainda tenham o mesmo valor na posição da raiz
+        if (def >= 0 && isTempName(operand) && count != uses.end() && count->second == 1 &&
+            chainClass(body[def].op) == kind && operandsStable(def)) {
+            return collect(def, negated);
+        }
+
+        leaves.push_back(std::make_pair(operand, negated));
+        return 0;
+    }
+
+    bool operandsStable(int pos) const {
+        const ThreeAddressCode& instr = body[pos];
+        for (const auto& name : instructionUses(instr)) {
+            if (defAt(name, pos) != defAt(name, rootPos)) return false;
+        }
+        return true;
+    }
+};
+
+// Reduz os operandos em pares, nível a nível: profundidade ceil(log2(n))
+std::string emitBalanced(IRModule& module, std::vector<std::string> operands, const std::string& op,
+                         std::vector<ThreeAddressCode>& out, int& depth) {
+    depth = 0;
+    while (operands.size() > 1) {
+        std::vector<std::string> next;
+        for (size_t i = 0; i + 1 < operands.size(); i += 2) {
+            std::string temp = module.newTemp();
+            out.push_back(ThreeAddressCode(temp, op, operands[i], operands[i + 1]));
+            next.push_back(temp);
+        }
+        if (operands.size() % 2 == 1) next.push_back(operands.back());
+        operands = next;
+        depth++;
+    }
+    return operands.empty() ? "" : operands[0];
+}
+
+} // namespace
+
+int rebalanceChains(IRFunction& func, IRModule& module, OptimizerStats& stats) {
+    std::map<std::string, int> uses;
+    for (const auto& instr : func.body) {
+        for (const auto& use : instructionUses(instr)) uses[use]++;
+    }
+
+    // Nós internos (temporário lido uma vez por uma operação da mesma classe)
+    // são reconstruídos junto com a raiz da cadeia
+    std::map<std::string, char> defClass;
+    std::set<std::string> interior;
+    for (const auto& instr : func.body) {
+        char kind = chainClass(instr.op);
+        if (kind) {
+            for (const auto& operand : {instr.arg1, instr.arg2}) {
+                auto it = defClass.find(operand);
+                if (it != defClass.end() && it->second == kind && uses[operand] == 1) interior.insert(operand);
+            }
+        }
+        if (isTempName(instr.result)) defClass[instr.result] = kind;
+    }
+
+    std::vector<ThreeAddressCode> body;
+    int rebalanced = 0;
+
+    for (int i = 0; i < static_cast<int>(func.body.size()); i++) {
+        const ThreeAddressCode& instr = func.body[i];
+        char kind = chainClass(instr.op);
+        if (!kind || interior.count(instr.result)) {
+            body.push_back(instr);
+            continue;
+        }
+
+        ChainCollector collector(func.body, uses, i);
+        int oldDepth = collector.collect(i, false);
+
+        std::vector<std::string> positive, negative;
+        for (const auto& leaf : collector.leaves) {
+            (leaf.second ? negative : positive).push_back(leaf.first);
+        }
+
+        std::vector<ThreeAddressCode> code;
+        int positiveDepth = 0, negativeDepth = 0;
+        std::string sum = emitBalanced(module, positive, kind == '+' ? "+" : "*", code, positiveDepth);
+        std::string subtracted = emitBalanced(module, negative, "+", code, negativeDepth);
+        int newDepth = std::max(positiveDepth, negativeDepth) + (negative.empty() ? 0 : 1);
+
+        if (positive.empty() || newDepth >= oldDepth) {
+            body.push_back(instr);
+            continue;
+        }
+
+        if (!negative.empty()) {
+            code.push_back(ThreeAddressCode(instr.result, "-", sum, subtracted));
+        } else {
+            code.back().result = instr.result;
+        }
+
+        // As instruções internas da cadeia antiga ficam mortas (DCE)
+        body.insert(body.end(), code.begin(), code.end());
+        stats.rebalancedChains++;
+        rebalanced++;
+    }
+
+    func.body = body;
+    return rebalanced;
+}
+
+int criticalPath(const IRFunction& func) {
+    // Maior cadeia de dependências entre instruções (código sem desvios)
+    std::map<std::string, int> depth;
+    int longest = 0;
+
+    for (const auto& instr : func.body) {
+        int current = 0;
+        for (const auto& use : instructionUses(instr)) {
+            auto it = depth.find(use);
+            if (it != depth.end()) current = std::max(current, it->second);
+        }
+        if (instr.op != "=" && instr.op != "RETURN") current++;
+        if (!instr.result.empty()) depth[instr.result] = current;
+        longest = std::max(longest, current);
+    }
+
+    return longest;
+}
+
+// ==================== CONTRAÇÃO EM FMA ====================
+
+int contractMultiplyAdd(IRFunction& func, OptimizerStats& stats) {
+    std::map<std::string, int> uses;
+    for (const auto& instr : func.body) {
+        for (const auto& use : instructionUses(instr)) uses[use]++;
+    }
+
+    // Multiplicações candidatas: resultado temporário lido uma única vez e
+    // operandos ainda com o mesmo valor no ponto de uso
+    std::map<std::string, size_t> products;
+    int fused = 0;
+
+    for (size_t i = 0; i < func.body.size(); i++) {
+        ThreeAddressCode& instr = func.body[i];
+
+        if (instr.op == "+" || instr.op == "-") {
+            auto candidate = [&](const std::string& operand) {
+                auto it = products.find(operand);
+                return it != products.end() && uses[operand] == 1 ? it->second : func.body.size();
+            };
+
+            size_t left = candidate(instr.arg1);
+            size_t right = candidate(instr.arg2);
+            const ThreeAddressCode* product = nullptr;
+            std::string op, addend;
+
+            if (left < func.body.size()) {
+                product = &func.body[left];
+                op = instr.op == "+" ? "FMA" : "FMS";
+                addend = instr.arg2;
+            } else if (right < func.body.size()) {
+                product = &func.body[right];
+                op = instr.op == "+" ? "FMA" : "FNMA";
+                addend = instr.arg1;
+            }
+
+            if (product) {
+                std::string productName = product->result;
+                instr = ThreeAddressCode(instr.result, op, product->arg1, product->arg2, addend);
+                // A multiplicação fica morta e é removida pelo DCE
+                uses[productName] = 0;
+                products.erase(productName);
+                fused++;
+            }
+        }
+
+        if (instr.result.empty()) continue;
+
+        // Redefinir um operando invalida as multiplicações que o leram
+        for (auto it = products.begin(); it != products.end();) {
+            const ThreeAddressCode& product = func.body[it->second];
+            if (it->first == instr.result || product.arg1 == instr.result || product.arg2 == instr.result) {
+                it = products.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (instr.op == "*" && isTempName(instr.result)) {
+            products[instr.result] = i;
+        }
+    }
+
+    stats.fusedOperations += fused;
+    return fused;
+}
+
+int simplifyFunction(IRFunction& func, OptimizerStats& stats) {
+    int total = 0;
+    int changes;
+
+    // Na forma SSA nenhum valor conhecido é invalidado por uma reatribuição:
+    // cada pass é uma varredura linear
+    int unreachable = removeUnreachableCode(func);
+    stats.unreachable += unreachable;
+    total += unreachable;
+    constructSSA(func);
+
+    do {
+        changes = propagateConstantsSSA(func, stats);
+        changes += numberValuesSSA(func, stats);
+
+        int dead = eliminateDeadCodeSSA(func);
+        stats.deadAssignments += dead;
+
+        changes += dead;
+        total += changes;
+    } while (changes > 0);
+
+    destructSSA(func);
+    return total;
+}
+
+// ==================== OTIMIZADOR ====================
+
+namespace {
+
+size_t countCalls(const IRModule& module) {
+    size_t calls = 0;
+    for (const auto& entry : countCallSites(module)) calls += entry.second;
+    return calls;
+}
+
+} // namespace
+
+Optimizer::Optimizer(const OptimizerOptions& opts) : options(opts) {}
+
+std::vector<ThreeAddressCode> Optimizer::optimize(const std::vector<ThreeAddressCode>& code) {
+    stats = OptimizerStats();
+    IRModule module = buildModule(code);
+    stats.sizeBefore = moduleSize(module);
+    stats.callsBefore = countCalls(module);
+    for (const auto& func : module.functions) stats.criticalPathBefore += criticalPath(func);
+
+    // Os passes são repetidos em conjunto até que nenhum deles altere o código
+    for (stats.iterations = 0; stats.iterations < options.maxIterations; ) {
+        stats.iterations++;
+        int changes = 0;
+
+        for (auto& func : module.functions) {
+            if (options.fastMath) changes += rewriteHorner(func, module, stats);
+            changes += reducePowers(func, module, options.fastMath, stats);
+            changes += simplifyFunction(func, stats);
+            if (options.fastMath && rebalanceChains(func, module, stats) > 0) {
+                changes += simplifyFunction(func, stats) + 1;
+            }
+        }
+
+        changes += evaluateConstantCalls(module, options.evalMaxDepth, options.evalMaxSteps, stats);
+        changes += inlineCalls(module, options.inlineThreshold, stats);
+
+        size_t growthLimit = stats.sizeBefore * options.specializeGrowth / 100;
+        size_t budget = growthLimit > stats.clonedInstructions ? growthLimit - stats.clonedInstructions : 0;
+        changes += specializeCalls(module, options.specializeMinCalls, budget, stats);
+
+        // Funções totalmente expandidas ou avaliadas deixam de ser chamadas
+        if (!options.entryPoints.empty()) {
+            changes += eliminateDeadArguments(module, options.entryPoints, stats);
+            int removed = removeUnreachableFunctions(module, options.entryPoints);
+            stats.removedFunctions += removed;
+            changes += removed;
+        }
+
+        if (changes == 0) break;
+    }
+
+    // E-graph sobre o resultado dos passes: explora reescritas equivalentes
+    // em conjunto em vez de aplicá-las em uma ordem fixa
+    if (options.egraph) {
+        EGraphOptions egraphOptions = options.egraphOptions;
+        egraphOptions.fastMath = options.fastMath;
+        for (auto& func : module.functions) {
+            EGraphResult result;
+            if (optimizeWithEGraph(func, module, egraphOptions, result)) {
+                stats.egraphFunctions++;
+                simplifyFunction(func, stats);
+            }
+            if (result.saturated) stats.egraphSaturated++;
+            stats.egraphCostBefore += result.costBefore;
+            stats.egraphCostAfter += functionCost(func);
+        }
+    }
+
+    // Contração por último: as demais reescritas enxergam + e * separados
+    if (options.fpContract) {
+        for (auto& func : module.functions) {
+            if (contractMultiplyAdd(func, stats) > 0) simplifyFunction(func, stats);
+        }
+    }
+
+    // União de funções idênticas sobre os corpos finais
+    mergeIdenticalFunctions(module, options.entryPoints, stats);
+
+    // Por último: os nomes passam a ser registradores virtuais reutilizados
+    if (options.reuseTemps) {
+        for (auto& func : module.functions) {
+            int before = frameSize(func);
+            int after = reuseTempSlots(func);
+            stats.frameBefore += before;
+            stats.frameAfter += after;
+            stats.maxFrameBefore = std::max(stats.maxFrameBefore, before);
+            stats.maxFrameAfter = std::max(stats.maxFrameAfter, after);
+        }
+    }
+
+    stats.sizeAfter = moduleSize(module);
+    stats.callsAfter = countCalls(module);
+    for (const auto& func : module.functions) stats.criticalPathAfter += criticalPath(func);
+    return flattenModule(module);
+}
+
+const OptimizerStats& Optimizer::getStats() const {
+    return stats;
+}
+
+std::string Optimizer::report() const {
+    std::ostringstream oss;
+    oss << "Iterações: " << stats.iterations << "\n";
+    oss << "Operandos propagados: " << stats.propagatedOperands << "\n";
+    oss << "Constantes dobradas: " << stats.foldedConstants << "\n";
+    oss << "Instruções inalcançáveis removidas: " << stats.unreachable << "\n";
+    oss << "Atribuições mortas removidas: " << stats.deadAssignments << "\n";
+    oss << "Expressões redundantes (numeração de valores): " << stats.redundantExpressions << "\n";
+    oss << "Potências reduzidas a multiplicações: " << stats.reducedPowers << "\n";
+    if (options.fastMath) {
+        oss << "Polinômios reescritos na forma de Horner: " << stats.hornerRewrites << "\n";
+    }
+    if (options.fastMath) {
+        oss << "Cadeias associativas rebalanceadas: " << stats.rebalancedChains << "\n";
+    }
+    if (options.fpContract) {
+        oss << "Operações fundidas em FMA: " << stats.fusedOperations << "\n";
+    }
+    if (options.egraph) {
+        oss << "E-graph: " << stats.egraphFunctions << " função(ões) reescrita(s), "
+            << stats.egraphSaturated << " saturada(s), custo " << stats.egraphCostBefore
+            << " -> " << stats.egraphCostAfter << "\n";
+    }
+    oss << "Chamadas expandidas em linha: " << stats.inlinedCalls << "\n";
+    oss << "Chamadas avaliadas em tempo de compilação: " << stats.evaluatedCalls;
+    if (stats.abandonedEvaluations > 0) {
+        oss << " (" << stats.abandonedEvaluations << " interrompida(s) pelos limites)";
+    }
+    oss << "\n";
+    oss << "Funções especializadas: " << stats.specializedFunctions
+        << " (" << stats.clonedInstructions << " instrução(ões) adicionada(s), "
+        << stats.specializationSavings << " economizada(s) nas chamadas)\n";
+    for (const auto& description : stats.specializations) {
+        oss << "  " << description << "\n";
+    }
+    if (!options.entryPoints.empty()) {
+        oss << "Funções inalcançáveis removidas: " << stats.removedFunctions << "\n";
+        oss << "Parâmetros mortos removidos: " << stats.removedParameters << " ("
+            << stats.removedArguments << " argumento(s) removido(s) nas chamadas)\n";
+    }
+    oss << "Funções idênticas unidas: " << stats.mergedFunctions << " (" << stats.mergeSavings
+        << " instrução(ões) a menos)\n";
+    if (options.reuseTemps) {
+        oss << "Registradores virtuais (soma por função): " << stats.frameBefore << " -> "
+            << stats.frameAfter << " (maior quadro: " << stats.maxFrameBefore << " -> "
+            << stats.maxFrameAfter << ")\n";
+    }
+    oss << "Instruções CALL: " << stats.callsBefore << " -> " << stats.callsAfter << "\n";
+    oss << "Caminho crítico (soma por função): " << stats.criticalPathBefore << " -> "
+        << stats.criticalPathAfter << "\n";
+    oss << "Instruções: " << stats.sizeBefore << " -> " << stats.sizeAfter << "\n";
+    return oss.str();
+}
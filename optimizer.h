@@ -0,0 +1,132 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "codegen.h"
+#include "egraph.h"
+#include "ir.h"
+#include <set>
+#include <string>
+#include <vector>
+
+struct OptimizerOptions {
+    int maxIterations;       // Limite de rodadas até o ponto fixo
+    bool fastMath;           // -ffast-math: permite reescritas que alteram o arredondamento
+    bool fpContract;         // -ffp-contract=fast: funde multiplicação e adição em FMA
+    int inlineThreshold;     // Tamanho máximo (instruções) de uma função expandida em linha
+    int evalMaxDepth;        // Limites da avaliação de chamadas em tempo de compilação
+    long evalMaxSteps;
+    int specializeMinCalls;  // Chamadas com o mesmo padrão constante para criar uma cópia
+    int specializeGrowth;    // Crescimento máximo do código pelas cópias (% do tamanho inicial)
+    std::vector<std::string> entryPoints;  // --entry: vazio = todas as funções são entradas
+    bool reuseTemps;         // Renomeia locais e temporários para registradores reutilizáveis
+    bool egraph;             // --egraph: saturação de igualdades + extração pelo menor custo
+    EGraphOptions egraphOptions;
+
+    OptimizerOptions()
+        : maxIterations(10), fastMath(false), fpContract(false), inlineThreshold(12), evalMaxDepth(64), evalMaxSteps(100000),
+          specializeMinCalls(2), specializeGrowth(20), reuseTemps(true), egraph(false) {}
+};
+
+struct OptimizerStats {
+    int iterations;
+    int propagatedOperands;  // Operandos substituídos por cópias/constantes
+    int foldedConstants;     // Operações avaliadas em tempo de compilação
+    int unreachable;         // Instruções após o primeiro RETURN
+    int deadAssignments;     // Atribuições cujo valor nunca é lido
+    int redundantExpressions;// Operações repetidas substituídas pelo primeiro resultado
+    int reducedPowers;       // Potências com expoente constante reescritas
+    int hornerRewrites;      // Somas polinomiais reescritas na forma de Horner
+    int rebalancedChains;    // Cadeias de + ou * reorganizadas em árvores balanceadas
+    int fusedOperations;     // Pares multiplicação + adição/subtração fundidos em FMA
+    int inlinedCalls;        // Chamadas expandidas em linha
+    int evaluatedCalls;      // Chamadas com argumentos constantes substituídas pelo resultado
+    int abandonedEvaluations;// Avaliações interrompidas pelos limites (ou com resultado não finito)
+    int specializedFunctions;         // Cópias especializadas criadas
+    size_t clonedInstructions;        // Instruções adicionadas pelas cópias
+    size_t specializationSavings;     // Instruções economizadas (por execução de cada chamada)
+    std::vector<std::string> specializations;
+    std::set<std::string> clones;     // Nomes das cópias criadas (reaproveitadas nas iterações seguintes)
+    int removedFunctions;    // Funções que deixaram de ser alcançáveis a partir das entradas
+    int removedParameters;   // Parâmetros nunca lidos removidos das funções internas
+    int removedArguments;    // Argumentos correspondentes removidos nas chamadas
+    int mergedFunctions;     // Funções idênticas unidas a outra (removidas ou transformadas em apelidos)
+    size_t mergeSavings;     // Instruções economizadas pela união
+    int egraphFunctions;     // Funções reescritas pelo e-graph
+    int egraphSaturated;     // Funções saturadas antes dos limites de nós/tempo
+    int egraphCostBefore;    // Custo estimado (ver operationCost) antes/depois da extração
+    int egraphCostAfter;
+    int frameBefore;         // Soma dos quadros: um nome por posição / registradores reutilizados
+    int frameAfter;
+    int maxFrameBefore;      // Maior quadro de uma função
+    int maxFrameAfter;
+    size_t callsBefore;      // Instruções CALL antes/depois da otimização
+    size_t callsAfter;
+    int criticalPathBefore;  // Soma dos caminhos críticos das funções
+    int criticalPathAfter;
+    size_t sizeBefore;
+    size_t sizeAfter;
+
+    OptimizerStats()
+        : iterations(0), propagatedOperands(0), foldedConstants(0),
+          unreachable(0), deadAssignments(0), redundantExpressions(0), reducedPowers(0), hornerRewrites(0), rebalancedChains(0), fusedOperations(0), inlinedCalls(0),
+          evaluatedCalls(0), abandonedEvaluations(0),
+          specializedFunctions(0), clonedInstructions(0), specializationSavings(0),
+          removedFunctions(0), removedParameters(0), removedArguments(0), mergedFunctions(0), mergeSavings(0), egraphFunctions(0), egraphSaturated(0), egraphCostBefore(0), egraphCostAfter(0),
+          frameBefore(0), frameAfter(0), maxFrameBefore(0), maxFrameAfter(0),
+          callsBefore(0), callsAfter(0), criticalPathBefore(0), criticalPathAfter(0),
+          sizeBefore(0), sizeAfter(0) {}
+};
+
+// ==================== PASSES LOCAIS ====================
+// Cada pass atua sobre uma função e retorna o número de alterações feitas.
+
+// Avalia a operação quando todos os operandos são literais e o resultado é
+// finito, transformando a instrução em "r = valor"
+bool foldInstruction(ThreeAddressCode& instr);
+
+// Remove tudo o que vem depois do primeiro RETURN
+int removeUnreachableCode(IRFunction& func);
+
+// Remove atribuições mortas usando análise de vivacidade (de trás para frente)
+int eliminateDeadCode(IRFunction& func);
+
+// Reescreve x ^ c com c constante: expoentes inteiros viram cadeias ótimas de
+// multiplicações (x^8 = três quadrados), negativos o recíproco da cadeia e,
+// com fastMath, x ^ 0.5 vira SQRT
+int reducePowers(IRFunction& func, IRModule& module, bool fastMath, OptimizerStats& stats);
+
+// Reconhece somas polinomiais em uma variável (a*x^3 + b*x^2 + c*x + d) e as
+// reescreve na forma de Horner (((a*x + b)*x + c)*x + d). Altera o arredondamento:
+// usado apenas com fastMath
+int rewriteHorner(IRFunction& func, IRModule& module, OptimizerStats& stats);
+
+// Reorganiza cadeias longas de + e - (ou de *) em árvores balanceadas, reduzindo
+// o caminho crítico de O(n) para O(log n). Altera o arredondamento: apenas com fastMath
+int rebalanceChains(IRFunction& func, IRModule& module, OptimizerStats& stats);
+
+// Maior cadeia de operações dependentes da função
+int criticalPath(const IRFunction& func);
+
+// Funde "t = a * b; u = t + c" em "u = FMA a, b, c" (e FMS/FNMA para subtrações)
+// quando t é lido uma única vez
+int contractMultiplyAdd(IRFunction& func, OptimizerStats& stats);
+
+// Executa os passes locais até o ponto fixo, sobre a forma SSA (ver ssa.h):
+// propagação de constantes, numeração de valores e eliminação de código morto
+int simplifyFunction(IRFunction& func, OptimizerStats& stats);
+
+// ==================== OTIMIZADOR ====================
+
+class Optimizer {
+private:
+    OptimizerOptions options;
+    OptimizerStats stats;
+
+public:
+    Optimizer(const OptimizerOptions& opts = OptimizerOptions());
+    std::vector<ThreeAddressCode> optimize(const std::vector<ThreeAddressCode>& code);
+    const OptimizerStats& getStats() const;
+    std::string report() const;
+};
+
+#endif // OPTIMIZER_H
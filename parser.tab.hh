@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,69 +31,74 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_TAB_HH_INCLUDED
+# define YY_YY_PARSER_TAB_HH_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     FUNCTION_TOKEN = 258,
-     RETURN_TOKEN = 259,
-     ID_TOKEN = 260,
-     NUM_TOKEN = 261,
-     PLUS_TOKEN = 262,
-     MINUS_TOKEN = 263,
-     MULT_TOKEN = 264,
-     DIV_TOKEN = 265,
-     POW_TOKEN = 266,
-     ASSIGN_TOKEN = 267,
-     LPAREN_TOKEN = 268,
-     RPAREN_TOKEN = 269,
-     LBRACE_TOKEN = 270,
-     RBRACE_TOKEN = 271,
-     COMMA_TOKEN = 272,
-     SEMICOLON_TOKEN = 273,
-     UNKNOWN_TOKEN = 274
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    FUNCTION_TOKEN = 258,          /* FUNCTION_TOKEN  */
+    RETURN_TOKEN = 259,            /* RETURN_TOKEN  */
+    ID_TOKEN = 260,                /* ID_TOKEN  */
+    NUM_TOKEN = 261,               /* NUM_TOKEN  */
+    PLUS_TOKEN = 262,              /* PLUS_TOKEN  */
+    MINUS_TOKEN = 263,             /* MINUS_TOKEN  */
+    MULT_TOKEN = 264,              /* MULT_TOKEN  */
+    DIV_TOKEN = 265,               /* DIV_TOKEN  */
+    POW_TOKEN = 266,               /* POW_TOKEN  */
+    ASSIGN_TOKEN = 267,            /* ASSIGN_TOKEN  */
+    LPAREN_TOKEN = 268,            /* LPAREN_TOKEN  */
+    RPAREN_TOKEN = 269,            /* RPAREN_TOKEN  */
+    LBRACE_TOKEN = 270,            /* LBRACE_TOKEN  */
+    RBRACE_TOKEN = 271,            /* RBRACE_TOKEN  */
+    COMMA_TOKEN = 272,             /* COMMA_TOKEN  */
+    SEMICOLON_TOKEN = 273,         /* SEMICOLON_TOKEN  */
+    UNKNOWN_TOKEN = 274            /* UNKNOWN_TOKEN  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define FUNCTION_TOKEN 258
-#define RETURN_TOKEN 259
-#define ID_TOKEN 260
-#define NUM_TOKEN 261
-#define PLUS_TOKEN 262
-#define MINUS_TOKEN 263
-#define MULT_TOKEN 264
-#define DIV_TOKEN 265
-#define POW_TOKEN 266
-#define ASSIGN_TOKEN 267
-#define LPAREN_TOKEN 268
-#define RPAREN_TOKEN 269
-#define LBRACE_TOKEN 270
-#define RBRACE_TOKEN 271
-#define COMMA_TOKEN 272
-#define SEMICOLON_TOKEN 273
-#define UNKNOWN_TOKEN 274
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 27 "parser.y"
+union YYSTYPE
 {
+#line 27 "parser.y"
+
     ASTNode* node_val;
     Token* token_val;
     std::string* string_val;
     int int_val;
-}
-/* Line 1529 of yacc.c.  */
-#line 94 "parser.tab.hh"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+
+#line 90 "parser.tab.hh"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
+
 extern YYSTYPE yylval;
 
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_PARSER_TAB_HH_INCLUDED  */
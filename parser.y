@@ -55,10 +55,11 @@ program:
     }
     ;
 
+// Recursiva à esquerda: a pilha do parser não cresce com o número de funções,
+// e a lista é um único nó FUNC_LIST com uma FUNC_DECL por filho
 function_list:
-    function_decl function_list {
-        $$ = new ASTNode(FUNC_LIST);
-        $$->addChild($1);
+    function_list function_decl {
+        $$ = $1;
         $$->addChild($2);
     }
     | /* epsilon */ {
@@ -72,7 +73,6 @@ function_decl:
         $$->addChild(new ASTNode(T_ID, $2->lexeme));
         $$->addChild($4);
         $$->addChild($7);
-        delete $2;
     }
     ;
 
@@ -91,21 +91,20 @@ param_list:
         ASTNode* node = new ASTNode(PARAM_LIST);
         node->addChild(new ASTNode(T_ID, $1->lexeme));
         $$ = node;
-        delete $1;
     }
     | ID_TOKEN COMMA_TOKEN param_list {
         ASTNode* node = new ASTNode(PARAM_LIST);
         node->addChild(new ASTNode(T_ID, $1->lexeme));
         node->addChild($3);
         $$ = node;
-        delete $1;
     }
     ;
 
+// Recursiva à esquerda, como function_list: um único nó STATEMENTS com um
+// STATEMENT por filho, em ordem
 statements:
-    statement statements {
-        $$ = new ASTNode(STATEMENTS);
-        $$->addChild($1);
+    statements statement {
+        $$ = $1;
         $$->addChild($2);
     }
     | /* epsilon */ {
@@ -123,7 +122,6 @@ statement:
         $$ = new ASTNode(STATEMENT);
         $$->addChild(new ASTNode(T_ID, $1->lexeme));
         $$->addChild($3);
-        delete $1;
     }
     ;
 
@@ -203,18 +201,15 @@ base:
     NUM_TOKEN {
         $$ = new ASTNode(BASE);
         $$->addChild(new ASTNode(T_NUM, $1->lexeme));
-        delete $1;
     }
     | ID_TOKEN {
         $$ = new ASTNode(BASE);
         $$->addChild(new ASTNode(T_ID, $1->lexeme));
-        delete $1;
     }
     | ID_TOKEN LPAREN_TOKEN args RPAREN_TOKEN {
         $$ = new ASTNode(BASE);
         $$->addChild(new ASTNode(T_ID, $1->lexeme));
         $$->addChild($3);
-        delete $1;
     }
     | LPAREN_TOKEN expr RPAREN_TOKEN {
         $$ = new ASTNode(BASE);
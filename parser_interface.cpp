@@ -6,6 +6,7 @@
 
 // Declarações do Flex
 extern void reset_lexer();
+extern void release_tokens();
 extern FILE* yyin;
 extern int yyparse();
 
@@ -46,6 +47,7 @@ ASTNode* parse_source(const std::string& source, std::string& error_msg) {
     }
     
     int result = yyparse();
+    release_tokens();
     
     // Limpar arquivo temporário
     fclose(yyin);
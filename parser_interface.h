@@ -12,6 +12,7 @@ extern int yyparse();
 
 // Funções do Flex (implementadas em lex.yy.cc)
 extern void reset_lexer();
+extern void release_tokens();
 extern FILE* yyin;
 
 // Variáveis globais do parser (definidas em parser_interface.cpp)
@@ -0,0 +1,314 @@
+#include "regalloc.h"
+#include "liveness.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <set>
+#include <sstream>
+
+bool findCallingConvention(const std::string& name, CallingConvention& convention) {
+    if (name == "sysv") {
+        convention = {name, 8, -1, true};
+    } else if (name == "win64") {
+        convention = {name, 4, 6, true};
+    } else if (name == "vm") {
+        convention = {name, 8, -1, false};
+    } else {
+        return false;
+    }
+    return true;
+}
+
+RegisterAllocator::RegisterAllocator(const RegAllocOptions& opts) : options(opts) {}
+
+namespace {
+
+std::string registerName(int reg) {
+    return "r" + std::to_string(reg);
+}
+
+} // namespace
+
+bool RegisterAllocator::allocateFunction(IRFunction& func) {
+    LivenessInfo info = analyzeLiveness(func);
+    const std::vector<LiveInterval>& intervals = info.intervals;
+    size_t n = func.body.size();
+
+    // Registradores reservados para recarregar operandos da pilha: um por
+    // operando da instrução mais larga
+    int scratch = 1;
+    for (const auto& instr : func.body) {
+        if (isFusedOp(instr.op)) scratch = 3;
+        else if (isBinaryOp(instr.op)) scratch = std::max(scratch, 2);
+    }
+    int usable = options.registers - scratch;
+    if (usable < 1) {
+        errorMsg = "a função '" + func.name + "' precisa de pelo menos " + std::to_string(scratch + 1) +
+                   " registradores (" + std::to_string(options.registers) + " disponível(is))";
+        return false;
+    }
+    int argRegs = std::min(convention.argRegisters, usable);
+
+    // CALLs antes de cada instrução: um intervalo atravessa uma chamada se
+    // existe um CALL estritamente entre a definição e a última leitura
+    std::vector<int> callsBefore(n + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+        callsBefore[i + 1] = callsBefore[i] + (func.body[i].op == "CALL" ? 1 : 0);
+    }
+    auto crossesCall = [&](const LiveInterval& interval) {
+        if (!convention.clobbers) return false;
+        return callsBefore[std::max(interval.end, 0)] - callsBefore[interval.start + 1] > 0;
+    };
+    auto preserved = [&](int reg) {
+        return !convention.clobbers || (convention.calleeSavedFrom >= 0 && reg >= convention.calleeSavedFrom);
+    };
+
+    // Localização de cada intervalo: registrador (>= 0), pilha (SPILLED) ou,
+    // para resultados nunca lidos sem registrador livre, um registrador de recarga
+    const int SPILLED = -1, DISCARDED = -2;
+    std::vector<int> location(intervals.size(), SPILLED);
+    std::vector<std::string> stackName(intervals.size());
+    std::vector<int> incoming(intervals.size(), -1);   // Registrador de chegada dos parâmetros
+
+    std::set<int> free;
+    int paramCount = 0;
+    for (int reg = 0; reg < usable; reg++) free.insert(reg);
+    for (size_t v = 0; v < intervals.size() && intervals[v].param; v++, paramCount++) {
+        if (paramCount < argRegs) {
+            incoming[v] = paramCount;
+            free.erase(paramCount);
+        } else {
+            stackName[v] = "a" + std::to_string(paramCount - argRegs);
+        }
+    }
+
+    // Menor registrador livre da classe pedida: preservado por chamadas ou, de
+    // preferência, um que não é (deixando os preservados para quem atravessa CALLs)
+    auto takeFree = [&](bool needPreserved) {
+        int chosen = -1;
+        for (int reg : free) {
+            if (needPreserved && !preserved(reg)) continue;
+            if (chosen < 0 || (preserved(chosen) && !preserved(reg))) chosen = reg;
+            if (!preserved(reg)) break;
+        }
+        if (chosen >= 0) free.erase(chosen);
+        return chosen;
+    };
+
+    std::set<std::pair<int, int>> active;   // (fim, intervalo), em registradores
+    std::vector<int> spilled;
+    int callSpills = 0;
+
+    for (size_t v = 0; v < intervals.size(); v++) {
+        const LiveInterval& interval = intervals[v];
+
+        while (!active.empty() && active.begin()->first <= interval.start) {
+            free.insert(location[active.begin()->second]);
+            active.erase(active.begin());
+        }
+
+        if (interval.param && incoming[v] < 0) continue;   // Chega na pilha
+
+        bool crossing = crossesCall(interval);
+        int reg = -1;
+        if (interval.param && (!crossing || preserved(incoming[v]))) {
+            reg = incoming[v];
+        } else {
+            reg = takeFree(crossing);
+            // Parâmetro copiado para um registrador preservado (ou guardado na
+            // pilha): o registrador de chegada fica livre após o prólogo
+            if (interval.param) free.insert(incoming[v]);
+        }
+
+        if (reg < 0 && !interval.param && interval.end == interval.start) {
+            location[v] = DISCARDED;
+            continue;
+        }
+
+        if (reg < 0) {
+            // Sem registrador: vai para a pilha o intervalo que termina mais tarde,
+            // entre os ativos com um registrador utilizável e o atual
+            auto victim = active.rend();
+            for (auto it = active.rbegin(); it != active.rend(); ++it) {
+                if (!crossing || preserved(location[it->second])) {
+                    victim = it;
+                    break;
+                }
+            }
+            if (victim != active.rend() && victim->first > interval.end) {
+                int other = victim->second;
+                reg = location[other];
+                location[other] = SPILLED;
+                spilled.push_back(other);
+                active.erase(std::next(victim).base());
+            } else {
+                spilled.push_back(v);
+                if (crossing && victim == active.rend()) callSpills++;
+                continue;
+            }
+        }
+
+        location[v] = reg;
+        active.insert(std::make_pair(interval.end, static_cast<int>(v)));
+    }
+
+    // Posições de pilha reutilizadas entre intervalos que não se sobrepõem
+    std::sort(spilled.begin(), spilled.end());
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> busy;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> freeSlots;
+    int slotCount = 0;
+    for (int v : spilled) {
+        while (!busy.empty() && busy.top().first <= intervals[v].start) {
+            freeSlots.push(busy.top().second);
+            busy.pop();
+        }
+        int slot;
+        if (freeSlots.empty()) {
+            slot = slotCount++;
+        } else {
+            slot = freeSlots.top();
+            freeSlots.pop();
+        }
+        stackName[v] = "s" + std::to_string(slot);
+        busy.push(std::make_pair(intervals[v].end, slot));
+    }
+
+    std::vector<bool> used(options.registers, false);
+    auto operandName = [&](int v) {
+        if (location[v] >= 0) {
+            used[location[v]] = true;
+            return registerName(location[v]);
+        }
+        return stackName[v];
+    };
+
+    // Prólogo: parâmetros que não ficam no registrador de chegada
+    std::vector<ThreeAddressCode> body;
+    int spills = 0, reloads = 0;
+    for (size_t v = 0; v < intervals.size() && intervals[v].param; v++) {
+        if (incoming[v] < 0 || location[v] == incoming[v]) continue;
+        used[incoming[v]] = true;
+        if (location[v] == SPILLED) {
+            body.push_back(ThreeAddressCode(stackName[v], "SPILL", registerName(incoming[v])));
+            spills++;
+        } else {
+            body.push_back(ThreeAddressCode(operandName(v), "=", registerName(incoming[v])));
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        ThreeAddressCode instr = func.body[i];
+        const std::map<std::string, int>& reads = info.uses[i];
+
+        // CALL e RETURN leem a pilha diretamente; as demais operações recarregam
+        // cada operando da pilha (uma vez por instrução) em um registrador reservado
+        bool memoryOperands = instr.op == "CALL" || instr.op == "RETURN";
+        std::map<std::string, std::string> reloaded;
+        rewriteUses(instr, [&](const std::string& operand) -> std::string {
+            if (operand.empty() || isNumber(operand)) return operand;
+            auto it = reads.find(operand);
+            // Nome lido antes de qualquer atribuição vale 0
+            if (it == reads.end()) return "0";
+            int v = it->second;
+            if (location[v] >= 0 || memoryOperands) return operandName(v);
+
+            auto done = reloaded.find(operand);
+            if (done != reloaded.end()) return done->second;
+            int reg = usable + static_cast<int>(reloaded.size());
+            used[reg] = true;
+            body.push_back(ThreeAddressCode(registerName(reg), "RELOAD", stackName[v]));
+            reloads++;
+            reloaded[operand] = registerName(reg);
+            return registerName(reg);
+        });
+
+        int def = info.defs[i];
+        if (def >= 0 && location[def] == SPILLED && instr.op == "=") {
+            // Cópia para a pilha: guarda o operando diretamente
+            body.push_back(ThreeAddressCode(stackName[def], "SPILL", instr.arg1));
+            spills++;
+            continue;
+        }
+        if (def >= 0 && location[def] < 0) {
+            // Resultado na pilha: calculado em um registrador reservado e guardado
+            used[usable] = true;
+            instr.result = registerName(usable);
+            body.push_back(instr);
+            if (location[def] == SPILLED) {
+                body.push_back(ThreeAddressCode(stackName[def], "SPILL", instr.result));
+                spills++;
+            }
+            continue;
+        }
+        if (def >= 0) instr.result = operandName(def);
+        // Cópias entre nomes que receberam o mesmo registrador desaparecem
+        if (instr.op == "=" && instr.arg1 == instr.result) continue;
+        body.push_back(instr);
+    }
+
+    for (size_t p = 0; p < func.params.size(); p++) {
+        func.params[p] = static_cast<int>(p) < argRegs ? registerName(p) : "a" + std::to_string(p - argRegs);
+    }
+    func.body = body;
+    func.maxLive = -1;
+
+    int registersUsed = std::count(used.begin(), used.end(), true);
+    func.annotation = "registradores: " + std::to_string(registersUsed) + " de " + std::to_string(options.registers) +
+                      ", pilha: " + std::to_string(slotCount) + ", spills: " + std::to_string(spills) +
+                      ", reloads: " + std::to_string(reloads);
+
+    stats.functions++;
+    stats.intervals += intervals.size();
+    stats.spilledIntervals += spilled.size();
+    stats.callSpills += callSpills;
+    stats.spills += spills;
+    stats.reloads += reloads;
+    stats.stackSlots += slotCount;
+    stats.maxRegisters = std::max(stats.maxRegisters, registersUsed);
+    return true;
+}
+
+bool RegisterAllocator::allocate(IRModule& module) {
+    errorMsg = "";
+    stats = RegAllocStats();
+    if (!findCallingConvention(options.convention, convention)) {
+        errorMsg = "convenção de chamada desconhecida '" + options.convention + "' (use sysv, win64 ou vm)";
+        return false;
+    }
+
+    stats.sizeBefore = moduleSize(module);
+    for (auto& func : module.functions) {
+        if (!allocateFunction(func)) return false;
+    }
+    stats.sizeAfter = moduleSize(module);
+    return true;
+}
+
+const RegAllocStats& RegisterAllocator::getStats() const {
+    return stats;
+}
+
+std::string RegisterAllocator::report() const {
+    std::ostringstream oss;
+    oss << "Convenção de chamada: " << convention.name << " (" << options.registers << " registradores, "
+        << convention.argRegisters << " para argumentos";
+    if (!convention.clobbers) {
+        oss << ", preservados nas chamadas";
+    } else if (convention.calleeSavedFrom >= 0) {
+        oss << ", r" << convention.calleeSavedFrom << " em diante preservados nas chamadas";
+    } else {
+        oss << ", nenhum preservado nas chamadas";
+    }
+    oss << ")\n";
+    oss << "Intervalos de vida: " << stats.intervals << " (" << stats.spilledIntervals << " na pilha, "
+        << stats.callSpills << " por atravessarem chamadas)\n";
+    oss << "Instruções SPILL: " << stats.spills << ", RELOAD: " << stats.reloads << "\n";
+    oss << "Posições de pilha (soma por função): " << stats.stackSlots << "\n";
+    oss << "Maior número de registradores usados por uma função: " << stats.maxRegisters << "\n";
+    oss << "Instruções: " << stats.sizeBefore << " -> " << stats.sizeAfter << "\n";
+    return oss.str();
+}
+
+std::string RegisterAllocator::getError() const {
+    return errorMsg;
+}
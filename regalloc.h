@@ -0,0 +1,67 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "ir.h"
+#include <string>
+
+// Convenção de chamada: quantos argumentos chegam em registradores e quais
+// registradores sobrevivem a um CALL
+struct CallingConvention {
+    std::string name;
+    int argRegisters;        // Argumentos em r0, r1, ...; os demais chegam na pilha (a0, a1, ...)
+    int calleeSavedFrom;     // Registradores a partir deste sobrevivem a chamadas (-1: nenhum)
+    bool clobbers;           // false: chamadas não destroem registradores (máquina virtual)
+};
+
+// sysv: 8 argumentos em registradores, todos destruídos por chamadas (como XMM0-15)
+// win64: 4 argumentos em registradores, r6 em diante preservados pela função chamada
+// vm: 8 argumentos em registradores, cada chamada tem seu próprio quadro
+bool findCallingConvention(const std::string& name, CallingConvention& convention);
+
+struct RegAllocOptions {
+    int registers;           // --registers=N: registradores físicos disponíveis
+    std::string convention;  // --call-conv=sysv|win64|vm
+
+    RegAllocOptions() : registers(16), convention("sysv") {}
+};
+
+struct RegAllocStats {
+    int functions;
+    int intervals;           // Intervalos de vida alocados
+    int spilledIntervals;    // Intervalos que vivem na pilha
+    int callSpills;          // ... por atravessarem um CALL sem registrador preservado
+    int spills;              // Instruções SPILL (registrador -> pilha)
+    int reloads;             // Instruções RELOAD (pilha -> registrador)
+    int stackSlots;          // Soma das posições de pilha das funções
+    int maxRegisters;        // Maior número de registradores usados por uma função
+    size_t sizeBefore;
+    size_t sizeAfter;
+
+    RegAllocStats()
+        : functions(0), intervals(0), spilledIntervals(0), callSpills(0), spills(0), reloads(0),
+          stackSlots(0), maxRegisters(0), sizeBefore(0), sizeAfter(0) {}
+};
+
+// Alocação por varredura linear (Poletto e Sarkar) sobre os intervalos de
+// analyzeLiveness: os operandos passam a ser registradores físicos (r0, r1, ...)
+// ou posições de pilha (s0, s1, ...). Os últimos registradores ficam reservados
+// para recarregar operandos da pilha; CALL e RETURN leem a pilha diretamente.
+// O resumo da alocação vai para o cabeçalho da função (annotation).
+class RegisterAllocator {
+private:
+    RegAllocOptions options;
+    CallingConvention convention;
+    RegAllocStats stats;
+    std::string errorMsg;
+
+    bool allocateFunction(IRFunction& func);
+
+public:
+    RegisterAllocator(const RegAllocOptions& opts = RegAllocOptions());
+    bool allocate(IRModule& module);
+    const RegAllocStats& getStats() const;
+    std::string report() const;
+    std::string getError() const;
+};
+
+#endif // REGALLOC_H
@@ -1,7 +1,7 @@
 #include "semantic.h"
 #include "utils.h"
 
-SemanticAnalyzer::SemanticAnalyzer() : currentFunction(nullptr) {}
+SemanticAnalyzer::SemanticAnalyzer() : currentFunction(nullptr), analyzedNodes(0) {}
 
 void SemanticAnalyzer::collectParams(ASTNode* paramNode, std::vector<std::string>& params) {
     if (paramNode->symbol != PARAMS) return;
@@ -82,9 +82,9 @@ bool SemanticAnalyzer::analyzeNode(ASTNode* node) {
         // Primeira passagem: coletar todas as funções
         if (!node->children.empty()) {
             ASTNode* funcList = node->children[0];
-            while (funcList && funcList->symbol == FUNC_LIST) {
-                if (!funcList->children.empty() && funcList->children[0]->symbol == FUNC_DECL) {
-                    ASTNode* funcDecl = funcList->children[0];
+            for (size_t i = 0; funcList && funcList->symbol == FUNC_LIST && i < funcList->children.size(); i++) {
+                ASTNode* funcDecl = funcList->children[i];
+                if (funcDecl->symbol == FUNC_DECL) {
                     if (funcDecl->children.size() >= 1 && funcDecl->children[0]->symbol == T_ID) {
                         std::string funcName = funcDecl->children[0]->value;
                         
@@ -105,12 +105,6 @@ bool SemanticAnalyzer::analyzeNode(ASTNode* node) {
                         functions[funcName] = info;
                     }
                 }
-                
-                if (funcList->children.size() > 1) {
-                    funcList = funcList->children[1];
-                } else {
-                    break;
-                }
             }
         }
         
@@ -133,20 +127,18 @@ bool SemanticAnalyzer::analyzeFunctionDecl(ASTNode* node) {
     if (node->children.size() < 3) return false;
     
     std::string funcName = node->children[0]->value;
+    
+    // Funções inalcançáveis a partir das entradas não são analisadas
+    if (!onlyFunctions.empty() && onlyFunctions.find(funcName) == onlyFunctions.end()) {
+        return true;
+    }
+    
     currentFunction = &functions[funcName];
+    analyzedNodes += countNodes(node);
     
     // Coletar variáveis locais (primeira passagem nos statements)
-    ASTNode* stmts = node->children[2];
-    while (stmts && stmts->symbol == STATEMENTS) {
-        if (!stmts->children.empty() && stmts->children[0]->symbol == STATEMENT) {
-            collectLocalVars(stmts->children[0]);
-        }
-        
-        if (stmts->children.size() > 1) {
-            stmts = stmts->children[1];
-        } else {
-            break;
-        }
+    for (auto stmt : node->children[2]->children) {
+        if (stmt->symbol == STATEMENT) collectLocalVars(stmt);
     }
     
     // Analisar statements
@@ -162,8 +154,6 @@ bool SemanticAnalyzer::analyzeStatements(ASTNode* node) {
     for (auto child : node->children) {
         if (child->symbol == STATEMENT) {
             if (!analyzeStatement(child)) return false;
-        } else if (child->symbol == STATEMENTS) {
-            if (!analyzeStatements(child)) return false;
         }
     }
     
@@ -240,6 +230,7 @@ bool SemanticAnalyzer::analyze(ASTNode* root) {
     errorMsg = "";
     functions.clear();
     currentFunction = nullptr;
+    analyzedNodes = 0;
     
     return analyzeNode(root);
 }
@@ -248,6 +239,14 @@ std::string SemanticAnalyzer::getError() const {
     return errorMsg;
 }
 
+void SemanticAnalyzer::restrictTo(const std::set<std::string>& names) {
+    onlyFunctions = names;
+}
+
+size_t SemanticAnalyzer::getAnalyzedNodes() const {
+    return analyzedNodes;
+}
+
 void SemanticAnalyzer::logError(const std::string& msg) {
     errorMsg = ::logError(msg);
 }
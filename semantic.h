@@ -19,6 +19,8 @@ private:
     std::map<std::string, FunctionInfo> functions;
     FunctionInfo* currentFunction;
     std::string errorMsg;
+    std::set<std::string> onlyFunctions;   // Vazio: analisa todas as funções
+    size_t analyzedNodes;
     
     bool analyzeNode(ASTNode* node);
     bool analyzeFunctionDecl(ASTNode* node);
@@ -36,6 +38,10 @@ public:
     SemanticAnalyzer();
     bool analyze(ASTNode* root);
     std::string getError() const;
+    
+    // Analisa apenas os corpos destas funções (as demais são só declaradas)
+    void restrictTo(const std::set<std::string>& names);
+    size_t getAnalyzedNodes() const;   // Nós dos corpos efetivamente analisados
 };
 
 #endif // SEMANTIC_H
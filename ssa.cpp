@@ -0,0 +1,208 @@
+#include "ssa.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+std::string ssaVersionName(const std::string& base, int version) {
+    return base + "." + std::to_string(version);
+}
+
+std::string ssaBaseName(const std::string& name) {
+    return name.substr(0, name.find('.'));
+}
+
+int constructSSA(IRFunction& func) {
+    // Nomes já usados: versões novas não podem colidir com eles (o código pode
+    // conter versões mantidas por uma destruição anterior)
+    std::unordered_set<std::string> names(func.params.begin(), func.params.end());
+    for (const auto& instr : func.body) {
+        if (!instr.result.empty()) names.insert(instr.result);
+        for (const auto& use : instructionUses(instr)) names.insert(use);
+    }
+
+    std::unordered_map<std::string, std::string> current;   // Versão atual de cada nome
+    std::unordered_map<std::string, int> versions;           // Última versão criada
+    for (const auto& param : func.params) {
+        current[param] = param;
+        versions[param] = 0;
+    }
+
+    int created = 0;
+    for (auto& instr : func.body) {
+        rewriteUses(instr, [&current](const std::string& operand) -> std::string {
+            if (operand.empty() || isNumber(operand)) return operand;
+            auto it = current.find(operand);
+            // Nome lido antes de qualquer atribuição vale 0
+            return it == current.end() ? "0" : it->second;
+        });
+        if (instr.result.empty()) continue;
+
+        std::string name = instr.result;
+        auto version = versions.find(instr.result);
+        if (version == versions.end()) {
+            versions[instr.result] = 0;
+        } else {
+            do {
+                name = ssaVersionName(ssaBaseName(instr.result), ++version->second);
+            } while (names.count(name));
+            names.insert(name);
+            created++;
+        }
+        current[instr.result] = name;
+        instr.result = name;
+    }
+
+    return created;
+}
+
+int destructSSA(IRFunction& func) {
+    std::unordered_set<std::string> names(func.params.begin(), func.params.end());
+    std::unordered_map<std::string, int> lastUse;
+    for (size_t i = 0; i < func.body.size(); i++) {
+        const ThreeAddressCode& instr = func.body[i];
+        if (!instr.result.empty()) names.insert(instr.result);
+        for (const auto& use : instructionUses(instr)) {
+            names.insert(use);
+            lastUse[use] = i;
+        }
+    }
+
+    // Versão que ocupa cada nome original no momento
+    std::unordered_map<std::string, std::string> holder;
+    for (const auto& param : func.params) holder[param] = param;
+
+    std::unordered_map<std::string, std::string> renamed;
+    int recovered = 0;
+    for (size_t i = 0; i < func.body.size(); i++) {
+        ThreeAddressCode& instr = func.body[i];
+        rewriteUses(instr, [&renamed](const std::string& operand) -> std::string {
+            auto it = renamed.find(operand);
+            return it == renamed.end() ? operand : it->second;
+        });
+        if (instr.result.empty()) continue;
+
+        std::string base = ssaBaseName(instr.result);
+        if (base == instr.result) {
+            holder[base] = base;
+            continue;
+        }
+
+        // O nome original está livre se a versão que o ocupa já foi lida pela
+        // última vez (os operandos são lidos antes da escrita do resultado)
+        auto it = holder.find(base);
+        bool available;
+        if (it == holder.end()) {
+            available = !names.count(base);
+        } else {
+            auto use = lastUse.find(it->second);
+            available = use == lastUse.end() || use->second <= static_cast<int>(i);
+        }
+        if (!available) continue;
+
+        holder[base] = instr.result;
+        renamed[instr.result] = base;
+        instr.result = base;
+        recovered++;
+    }
+
+    return recovered;
+}
+
+int propagateConstantsSSA(IRFunction& func, OptimizerStats& stats) {
+    int changes = 0;
+    // Valor conhecido de cada nome: um literal ou outro nome (cópia)
+    std::unordered_map<std::string, std::string> values;
+
+    for (auto& instr : func.body) {
+        rewriteUses(instr, [&](const std::string& operand) -> std::string {
+            auto it = values.find(operand);
+            if (it == values.end()) return operand;
+            changes++;
+            stats.propagatedOperands++;
+            return it->second;
+        });
+
+        if (foldInstruction(instr)) {
+            changes++;
+            stats.foldedConstants++;
+        }
+
+        if (instr.op == "=" && instr.arg1 != instr.result) {
+            values[instr.result] = instr.arg1;
+        }
+    }
+
+    return changes;
+}
+
+int numberValuesSSA(IRFunction& func, OptimizerStats& stats) {
+    int changes = 0;
+    // Expressão (operação e operandos) -> primeiro nome que a calcula
+    std::unordered_map<std::string, std::string> table;
+
+    for (auto& instr : func.body) {
+        if (instr.result.empty() || instr.op == "=") continue;
+
+        std::string a = instr.arg1, b = instr.arg2;
+        // + e * são comutativos (inclusive em ponto flutuante), assim como os
+        // fatores de FMA, FMS e FNMA
+        bool commutative = instr.op == "+" || instr.op == "*" || isFusedOp(instr.op);
+        if (commutative && b < a) std::swap(a, b);
+        std::string key = instr.op + "|" + a + "|" + b + "|" + instr.arg3;
+
+        auto it = table.find(key);
+        if (it == table.end()) {
+            table[key] = instr.result;
+            continue;
+        }
+        instr = ThreeAddressCode(instr.result, "=", it->second);
+        changes++;
+        stats.redundantExpressions++;
+    }
+
+    return changes;
+}
+
+int eliminateDeadCodeSSA(IRFunction& func) {
+    std::unordered_map<std::string, int> uses;
+    std::unordered_map<std::string, int> definition;
+    std::vector<int> worklist;
+
+    for (size_t i = 0; i < func.body.size(); i++) {
+        const ThreeAddressCode& instr = func.body[i];
+        for (const auto& use : instructionUses(instr)) uses[use]++;
+        if (!instr.result.empty()) definition[instr.result] = i;
+    }
+
+    // Todas as operações são puras (inclusive CALL): uma definição sem
+    // leituras pode ser descartada, e com ela os usos dos seus operandos
+    for (size_t i = 0; i < func.body.size(); i++) {
+        const ThreeAddressCode& instr = func.body[i];
+        if (!instr.result.empty() && !uses.count(instr.result)) worklist.push_back(i);
+    }
+
+    std::vector<bool> removed(func.body.size(), false);
+    int count = 0;
+    while (!worklist.empty()) {
+        int i = worklist.back();
+        worklist.pop_back();
+        if (removed[i]) continue;
+        removed[i] = true;
+        count++;
+
+        for (const auto& use : instructionUses(func.body[i])) {
+            if (--uses[use] > 0) continue;
+            auto def = definition.find(use);
+            if (def != definition.end()) worklist.push_back(def->second);
+        }
+    }
+
+    if (count == 0) return 0;
+    std::vector<ThreeAddressCode> kept;
+    kept.reserve(func.body.size() - count);
+    for (size_t i = 0; i < func.body.size(); i++) {
+        if (!removed[i]) kept.push_back(func.body[i]);
+    }
+    func.body = kept;
+    return count;
+}
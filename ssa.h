@@ -0,0 +1,43 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include "ir.h"
+#include "optimizer.h"
+#include <string>
+
+// ==================== FORMA SSA ====================
+// Cada nome é definido uma única vez. A primeira definição de um nome (ou o
+// parâmetro) mantém o nome original; as reatribuições recebem versões
+// "x.1", "x.2", ... (o ponto não pode aparecer em identificadores da linguagem).
+// Funções neto não têm desvios: o corpo é um único bloco básico e a
+// construção não precisa de nós phi.
+
+// Versão de um nome na forma SSA e o nome original de uma versão
+std::string ssaVersionName(const std::string& base, int version);
+std::string ssaBaseName(const std::string& name);
+
+// Converte a função para a forma SSA. Leituras de nomes ainda não atribuídos
+// viram o literal 0. Retorna o número de versões criadas.
+int constructSSA(IRFunction& func);
+
+// Volta da forma SSA: cada versão recupera o nome original quando a versão
+// anterior já não está viva; versões que se sobrepõem (após propagação de
+// cópias, por exemplo) mantêm o nome versionado. Retorna os nomes recuperados.
+int destructSSA(IRFunction& func);
+
+// ==================== PASSES SOBRE SSA ====================
+// Sem reatribuições, um valor conhecido nunca é invalidado: cada pass é uma
+// única varredura linear.
+
+// Propagação de cópias e constantes com dobramento de constantes
+int propagateConstantsSSA(IRFunction& func, OptimizerStats& stats);
+
+// Numeração de valores: uma operação repetida com os mesmos operandos (a menos
+// da ordem em + e *) vira cópia do primeiro resultado. Chamadas também são
+// numeradas, pois todas as funções são puras.
+int numberValuesSSA(IRFunction& func, OptimizerStats& stats);
+
+// Remove definições sem leituras, em cascata, por contagem de usos
+int eliminateDeadCodeSSA(IRFunction& func);
+
+#endif // SSA_H
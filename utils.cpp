@@ -8,3 +8,15 @@ std::string logSuccess(const std::string& msg) {
     return "\033[1;32m" + msg + "\033[0m";
 }
 
+
+std::string plainMessage(const std::string& msg) {
+    std::string plain;
+    for (size_t i = 0; i < msg.size(); i++) {
+        if (msg[i] == '\033') {
+            while (i < msg.size() && msg[i] != 'm') i++;
+            continue;
+        }
+        plain += msg[i];
+    }
+    return plain;
+}
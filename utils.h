@@ -5,6 +5,8 @@
 
 std::string logError(const std::string& msg);
 std::string logSuccess(const std::string& msg);
+// Mensagem sem as cores de logError/logSuccess
+std::string plainMessage(const std::string& msg);
 
 #endif // UTILS_H
 
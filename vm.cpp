@@ -0,0 +1,666 @@
+#include "vm.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+// Registradores iniciais da pilha (cresce sob demanda)
+const size_t INITIAL_STACK = 1 << 16;
+
+const char* opCodeName(OpCode op) {
+    switch (op) {
+        case OpCode::LOADK: return "LOADK";
+        case OpCode::MOVE: return "MOVE";
+        case OpCode::ADD: return "ADD";
+        case OpCode::SUB: return "SUB";
+        case OpCode::MUL: return "MUL";
+        case OpCode::DIV: return "DIV";
+        case OpCode::POW: return "POW";
+        case OpCode::SQRT: return "SQRT";
+        case OpCode::LOG: return "LOG";
+        case OpCode::FMA: return "FMA";
+        case OpCode::FMS: return "FMS";
+        case OpCode::FNMA: return "FNMA";
+        case OpCode::CALL: return "CALL";
+        case OpCode::RETURN: return "RETURN";
+        case OpCode::MULADD: return "MULADD";
+        case OpCode::MULSUB: return "MULSUB";
+        case OpCode::ADDK: return "ADDK";
+        case OpCode::SUBK: return "SUBK";
+        case OpCode::MULK: return "MULK";
+        case OpCode::DIVK: return "DIVK";
+        case OpCode::POWK: return "POWK";
+        case OpCode::KSUB: return "KSUB";
+        case OpCode::KDIV: return "KDIV";
+        case OpCode::TAILCALL: return "TAILCALL";
+    }
+    return "?";
+}
+
+OpCode arithmeticOpCode(const std::string& op) {
+    if (op == "+") return OpCode::ADD;
+    if (op == "-") return OpCode::SUB;
+    if (op == "*") return OpCode::MUL;
+    if (op == "/") return OpCode::DIV;
+    if (op == "^") return OpCode::POW;
+    if (op == "SQRT") return OpCode::SQRT;
+    if (op == "LOG") return OpCode::LOG;
+    if (op == "FMA") return OpCode::FMA;
+    if (op == "FMS") return OpCode::FMS;
+    return OpCode::FNMA;
+}
+
+// Registrador escrito por uma instrução (-1: nenhum)
+int32_t writtenRegister(const Instruction& in) {
+    return in.op == OpCode::RETURN || in.op == OpCode::TAILCALL ? -1 : in.a;
+}
+
+// Registradores lidos por uma instrução (as listas de CALL e RETURN ficam em operands)
+void readRegisters(const BytecodeFunction& func, const Instruction& in, std::vector<int32_t>& reads) {
+    reads.clear();
+    switch (in.op) {
+        case OpCode::LOADK:
+            break;
+        case OpCode::MOVE: case OpCode::SQRT: case OpCode::LOG:
+        case OpCode::ADDK: case OpCode::SUBK: case OpCode::MULK: case OpCode::DIVK: case OpCode::POWK:
+        case OpCode::KSUB: case OpCode::KDIV:
+            reads.push_back(in.b);
+            break;
+        case OpCode::ADD: case OpCode::SUB: case OpCode::MUL: case OpCode::DIV: case OpCode::POW:
+            reads.push_back(in.b);
+            reads.push_back(in.c);
+            break;
+        case OpCode::FMA: case OpCode::FMS: case OpCode::FNMA: case OpCode::MULADD: case OpCode::MULSUB:
+            reads.push_back(in.b);
+            reads.push_back(in.c);
+            reads.push_back(in.d);
+            break;
+        case OpCode::CALL: case OpCode::TAILCALL:
+            reads.insert(reads.end(), func.operands.begin() + in.c, func.operands.begin() + in.c + in.d);
+            break;
+        case OpCode::RETURN:
+            reads.insert(reads.end(), func.operands.begin() + in.a, func.operands.begin() + in.a + in.b);
+            break;
+    }
+}
+
+// Operação com uma constante: r[a] = r[b] op k ou, com constantFirst, k op r[b]
+bool constantOpCode(OpCode op, bool constantFirst, OpCode& fusedOp) {
+    switch (op) {
+        case OpCode::ADD: fusedOp = OpCode::ADDK; return true;
+        case OpCode::MUL: fusedOp = OpCode::MULK; return true;
+        case OpCode::SUB: fusedOp = constantFirst ? OpCode::KSUB : OpCode::SUBK; return true;
+        case OpCode::DIV: fusedOp = constantFirst ? OpCode::KDIV : OpCode::DIVK; return true;
+        case OpCode::POW: fusedOp = OpCode::POWK; return !constantFirst;
+        default: return false;
+    }
+}
+
+} // namespace
+
+VM::VM(const std::vector<ThreeAddressCode>& code, const VMOptions& opts)
+    : options(opts), maxDepth(1000), calls(0), instructions(0) {
+    load(buildModule(code));
+}
+
+VM::VM(const IRModule& module, const VMOptions& opts)
+    : options(opts), maxDepth(1000), calls(0), instructions(0) {
+    load(module);
+}
+
+void VM::load(const IRModule& module) {
+    functions.resize(module.functions.size());
+    for (size_t i = 0; i < module.functions.size(); i++) {
+        index[module.functions[i].name] = i;
+        functions[i].params = module.functions[i].params.size();
+    }
+    // As chamadas referem-se às funções pelo índice (e conferem a aridade)
+    for (size_t i = 0; i < module.functions.size(); i++) {
+        translate(module.functions[i], functions[i]);
+    }
+    if (options.superinstructions) {
+        for (auto& func : functions) fuse(func);
+    }
+
+#if VM_THREADED_DISPATCH
+    // Despacho direto: cada instrução guarda o endereço do seu tratador
+    if (options.threaded) {
+        const void* const* handlers = nullptr;
+        double unused;
+        run<true>(-1, nullptr, unused, nullptr, &handlers);
+        for (auto& func : functions) {
+            for (auto& in : func.code) in.handler = handlers[static_cast<int>(in.op)];
+        }
+    }
+#else
+    options.threaded = false;
+#endif
+    stack.resize(INITIAL_STACK);
+}
+
+void VM::fuse(BytecodeFunction& target) {
+    const std::vector<Instruction>& code = target.code;
+    size_t n = code.size();
+    if (!target.error.empty() || n == 0) return;
+
+    // deadAfterNext[i]: o registrador escrito pela instrução i não é lido depois
+    // da instrução i + 1 (vivacidade para trás, registrador por registrador)
+    std::vector<char> deadAfterNext(n, 0);
+    std::vector<char> live(target.registers, 0);
+    std::vector<int32_t> reads;
+    for (size_t j = n; j-- > 0;) {
+        if (j > 0) {
+            int32_t t = writtenRegister(code[j - 1]);
+            if (t >= 0) deadAfterNext[j - 1] = !live[t];
+        }
+        int32_t w = writtenRegister(code[j]);
+        if (w >= 0) live[w] = 0;
+        readRegisters(target, code[j], reads);
+        for (int32_t reg : reads) live[reg] = 1;
+    }
+
+    std::vector<Instruction> out;
+    out.reserve(n);
+    size_t last = n;   // Instrução original que produziu out.back()
+    for (size_t i = 0; i < n; i++) {
+        const Instruction& in = code[i];
+        bool adjacent = !out.empty() && last + 1 == i;
+        Instruction* prev = adjacent ? &out.back() : nullptr;
+
+        // CALL seguido de RETURN do resultado: chamada de cauda (a função chamada
+        // precisa retornar um único valor, que passa a ser o desta chamada)
+        if (prev && prev->op == OpCode::CALL && in.op == OpCode::RETURN && in.b == 1 &&
+            target.operands[in.a] == prev->a) {
+            const BytecodeFunction& callee = functions[prev->b];
+            bool singleValue = callee.error.empty() &&
+                               (callee.code.back().op != OpCode::RETURN || callee.code.back().b == 1);
+            if (singleValue) {
+                *prev = Instruction(OpCode::TAILCALL, 0, prev->b, prev->c, prev->d);
+                fused["TAILCALL"]++;
+                last = i;
+                continue;
+            }
+        }
+
+        // As demais fusões eliminam o registrador intermediário t, que não
+        // pode ser lido depois
+        if (prev && writtenRegister(*prev) >= 0 && deadAfterNext[i - 1]) {
+            int32_t t = prev->a;
+
+            // op t, ...; MOVE x, t: a operação escreve direto em x
+            if (in.op == OpCode::MOVE && in.b == t) {
+                prev->a = in.a;
+                fused["op+MOVE"]++;
+                last = i;
+                continue;
+            }
+
+            // LOADK t, k; op x, y, t: a constante vira operando da operação
+            bool binary = in.op == OpCode::ADD || in.op == OpCode::SUB || in.op == OpCode::MUL ||
+                          in.op == OpCode::DIV || in.op == OpCode::POW;
+            OpCode fusedOp;
+            if (prev->op == OpCode::LOADK && binary && (in.b == t) != (in.c == t) &&
+                constantOpCode(in.op, in.b == t, fusedOp)) {
+                int32_t other = in.b == t ? in.c : in.b;
+                *prev = Instruction(fusedOp, in.a, other, prev->b);
+                fused[opCodeName(fusedOp)]++;
+                last = i;
+                continue;
+            }
+
+            // MUL t, x, y; ADD z, t, w (ou w + t) / SUB z, t, w: produto e soma
+            // com os mesmos dois arredondamentos
+            bool addition = in.op == OpCode::ADD && (in.b == t) != (in.c == t);
+            bool subtraction = in.op == OpCode::SUB && in.b == t && in.c != t;
+            if (prev->op == OpCode::MUL && (addition || subtraction)) {
+                int32_t other = in.b == t ? in.c : in.b;
+                OpCode fusedOp = addition ? OpCode::MULADD : OpCode::MULSUB;
+                *prev = Instruction(fusedOp, in.a, prev->b, prev->c, other);
+                fused[opCodeName(fusedOp)]++;
+                last = i;
+                continue;
+            }
+        }
+
+        out.push_back(in);
+        last = i;
+    }
+
+    target.code = out;
+}
+
+void VM::translate(const IRFunction& func, BytecodeFunction& target) {
+    target.name = func.name;
+
+    // Um registrador por nome: parâmetros primeiro, depois na ordem das definições
+    std::unordered_map<std::string, int> registers;
+    for (size_t i = 0; i < func.params.size(); i++) registers[func.params[i]] = i;
+    for (const auto& instr : func.body) {
+        if (!instr.result.empty() && !registers.count(instr.result)) {
+            int next = registers.size();
+            registers[instr.result] = next;
+        }
+    }
+    int named = registers.size();
+
+    std::unordered_map<std::string, int> constants;
+    auto constant = [&](const std::string& text) {
+        auto it = constants.find(text);
+        if (it != constants.end()) return it->second;
+        int k = target.constants.size();
+        target.constants.push_back(toNumber(text));
+        constants[text] = k;
+        return k;
+    };
+
+    // Literais (e nomes lidos antes de qualquer atribuição, que valem 0) são
+    // carregados em registradores temporários logo antes da operação
+    std::unordered_set<std::string> defined(func.params.begin(), func.params.end());
+    int scratch = 0, maxScratch = 0;
+    auto operand = [&](const std::string& name) -> int32_t {
+        if (!isNumber(name) && defined.count(name)) return registers[name];
+        int reg = named + scratch++;
+        maxScratch = std::max(maxScratch, scratch);
+        target.code.push_back(Instruction(OpCode::LOADK, reg, constant(isNumber(name) ? name : "0")));
+        return reg;
+    };
+
+    bool returned = false;
+    for (const auto& instr : func.body) {
+        scratch = 0;
+        if (instr.op == "RETURN") {
+            std::vector<std::string> values = splitArgs(instr.arg1);
+            std::vector<int32_t> list;
+            for (const auto& value : values) list.push_back(operand(value));
+            target.code.push_back(Instruction(OpCode::RETURN, target.operands.size(), list.size()));
+            target.operands.insert(target.operands.end(), list.begin(), list.end());
+            returned = true;
+            break;
+        }
+
+        int32_t result = registers[instr.result];
+        if (isCopyOp(instr.op)) {
+            if (isNumber(instr.arg1) || !defined.count(instr.arg1)) {
+                target.code.push_back(Instruction(OpCode::LOADK, result, constant(isNumber(instr.arg1) ? instr.arg1 : "0")));
+            } else {
+                target.code.push_back(Instruction(OpCode::MOVE, result, registers[instr.arg1]));
+            }
+        } else if (isBinaryOp(instr.op)) {
+            int32_t a = operand(instr.arg1);
+            int32_t b = operand(instr.arg2);
+            target.code.push_back(Instruction(arithmeticOpCode(instr.op), result, a, b));
+        } else if (isUnaryOp(instr.op)) {
+            int32_t a = operand(instr.arg1);
+            target.code.push_back(Instruction(arithmeticOpCode(instr.op), result, a));
+        } else if (isFusedOp(instr.op)) {
+            int32_t a = operand(instr.arg1);
+            int32_t b = operand(instr.arg2);
+            int32_t c = operand(instr.arg3);
+            target.code.push_back(Instruction(arithmeticOpCode(instr.op), result, a, b, c));
+        } else if (instr.op == "CALL") {
+            auto callee = index.find(instr.arg1);
+            std::vector<std::string> args = splitArgs(instr.arg2);
+            if (callee == index.end()) {
+                target.error = "função '" + instr.arg1 + "' não existe";
+                return;
+            }
+            if (static_cast<int>(args.size()) != functions[callee->second].params) {
+                target.error = "função '" + instr.arg1 + "' espera " + std::to_string(functions[callee->second].params) +
+                               " argumento(s), mas " + std::to_string(args.size()) + " foi(ram) fornecido(s)";
+                return;
+            }
+
+            std::vector<int32_t> list;
+            for (const auto& arg : args) list.push_back(operand(arg));
+            target.code.push_back(Instruction(OpCode::CALL, result, callee->second, target.operands.size(), list.size()));
+            target.operands.insert(target.operands.end(), list.begin(), list.end());
+        } else {
+            target.error = "operação desconhecida '" + instr.op + "'";
+            return;
+        }
+        defined.insert(instr.result);
+    }
+
+    // Função sem RETURN retorna 0
+    if (!returned) {
+        scratch = 0;
+        int32_t zero = operand("0");
+        target.code.push_back(Instruction(OpCode::RETURN, target.operands.size(), 1));
+        target.operands.push_back(zero);
+    }
+
+    target.registers = named + maxScratch;
+}
+
+void VM::setMaxDepth(int depthLimit) {
+    maxDepth = depthLimit;
+}
+
+int VM::function(const std::string& name) const {
+    auto it = index.find(name);
+    return it == index.end() ? -1 : it->second;
+}
+
+int VM::arity(int function) const {
+    return functions[function].params;
+}
+
+bool VM::execute(int entry, const double* args, double& result, std::vector<double>* values) {
+#if VM_THREADED_DISPATCH
+    if (options.threaded) return run<true>(entry, args, result, values);
+#endif
+    return run<false>(entry, args, result, values);
+}
+
+// Cada operação é escrita uma única vez: no modo switch, VM_NEXT volta ao
+// switch (um único desvio indireto para todas as operações); no modo direto,
+// cada tratador salta para o tratador da próxima instrução, o que dá ao
+// preditor de desvios um histórico por operação
+#if VM_THREADED_DISPATCH
+#define VM_CASE(name) case OpCode::name: op_##name:
+#define VM_NEXT()                                      \
+    do {                                               \
+        if constexpr (Threaded) {                      \
+            in = pc++;                                 \
+            goto *in->handler;                         \
+        } else {                                       \
+            goto dispatch;                             \
+        }                                              \
+    } while (0)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-label"
+#else
+#define VM_CASE(name) case OpCode::name:
+#define VM_NEXT() goto dispatch
+#endif
+
+template <bool Threaded>
+bool VM::run(int entry, const double* args, double& result, std::vector<double>* values,
+             const void* const** handlers) {
+#if VM_THREADED_DISPATCH
+    if constexpr (Threaded) {
+        // Na ordem de OpCode
+        static const void* const labels[] = {
+            &&op_LOADK, &&op_MOVE, &&op_ADD, &&op_SUB, &&op_MUL, &&op_DIV, &&op_POW,
+            &&op_SQRT, &&op_LOG, &&op_FMA, &&op_FMS, &&op_FNMA, &&op_CALL, &&op_RETURN,
+            &&op_MULADD, &&op_MULSUB, &&op_ADDK, &&op_SUBK, &&op_MULK, &&op_DIVK, &&op_POWK,
+            &&op_KSUB, &&op_KDIV, &&op_TAILCALL
+        };
+        if (entry < 0) {
+            *handlers = labels;
+            return true;
+        }
+    }
+#else
+    (void)handlers;
+#endif
+
+    const BytecodeFunction* f = &functions[entry];
+    if (!f->error.empty()) {
+        errorMsg = f->error;
+        return false;
+    }
+    if (stack.size() < static_cast<size_t>(f->registers)) stack.resize(2 * f->registers);
+
+    frames.clear();
+    size_t base = 0;
+    double* r = stack.data();
+    std::copy(args, args + f->params, r);
+    const double* k = f->constants.data();
+    const int32_t* list = f->operands.data();
+    const Instruction* pc = f->code.data();
+    const Instruction* in;
+    int depth = 1;           // Chamadas ativas, inclusive as de cauda
+    int tailCalls = 0;       // Chamadas de cauda que reutilizaram o quadro atual
+    calls++;
+
+dispatch:
+    in = pc++;
+#if VM_THREADED_DISPATCH
+    if constexpr (Threaded) goto *in->handler;
+#endif
+    switch (in->op) {
+        VM_CASE(LOADK) r[in->a] = k[in->b]; VM_NEXT();
+        VM_CASE(MOVE) r[in->a] = r[in->b]; VM_NEXT();
+        VM_CASE(ADD) r[in->a] = r[in->b] + r[in->c]; VM_NEXT();
+        VM_CASE(SUB) r[in->a] = r[in->b] - r[in->c]; VM_NEXT();
+        VM_CASE(MUL) r[in->a] = r[in->b] * r[in->c]; VM_NEXT();
+        VM_CASE(DIV) r[in->a] = r[in->b] / r[in->c]; VM_NEXT();
+        VM_CASE(POW) r[in->a] = std::pow(r[in->b], r[in->c]); VM_NEXT();
+        VM_CASE(SQRT) r[in->a] = std::sqrt(r[in->b]); VM_NEXT();
+        VM_CASE(LOG) r[in->a] = std::log(r[in->b]); VM_NEXT();
+        VM_CASE(FMA) r[in->a] = std::fma(r[in->b], r[in->c], r[in->d]); VM_NEXT();
+        VM_CASE(FMS) r[in->a] = std::fma(r[in->b], r[in->c], -r[in->d]); VM_NEXT();
+        VM_CASE(FNMA) r[in->a] = std::fma(-r[in->b], r[in->c], r[in->d]); VM_NEXT();
+        // Sem contração (-std=c++17 implica -ffp-contract=off): o produto é
+        // arredondado antes da soma, como em MUL seguido de ADD
+        VM_CASE(MULADD) r[in->a] = r[in->b] * r[in->c] + r[in->d]; VM_NEXT();
+        VM_CASE(MULSUB) r[in->a] = r[in->b] * r[in->c] - r[in->d]; VM_NEXT();
+        VM_CASE(ADDK) r[in->a] = r[in->b] + k[in->c]; VM_NEXT();
+        VM_CASE(SUBK) r[in->a] = r[in->b] - k[in->c]; VM_NEXT();
+        VM_CASE(MULK) r[in->a] = r[in->b] * k[in->c]; VM_NEXT();
+        VM_CASE(DIVK) r[in->a] = r[in->b] / k[in->c]; VM_NEXT();
+        VM_CASE(POWK) r[in->a] = std::pow(r[in->b], k[in->c]); VM_NEXT();
+        VM_CASE(KSUB) r[in->a] = k[in->c] - r[in->b]; VM_NEXT();
+        VM_CASE(KDIV) r[in->a] = k[in->c] / r[in->b]; VM_NEXT();
+        VM_CASE(CALL) {
+            const BytecodeFunction* callee = &functions[in->b];
+            if (!callee->error.empty()) {
+                errorMsg = callee->error;
+                return false;
+            }
+            if (depth >= maxDepth) {
+                errorMsg = "profundidade máxima de chamadas excedida em '" + callee->name + "'";
+                return false;
+            }
+
+            // O quadro da função chamada começa logo após o quadro atual
+            size_t next = base + f->registers;
+            if (stack.size() < next + callee->registers) {
+                stack.resize(2 * (next + callee->registers));
+                r = stack.data() + base;
+            }
+            double* calleeRegisters = stack.data() + next;
+            for (int32_t j = 0; j < in->d; j++) calleeRegisters[j] = r[list[in->c + j]];
+
+            frames.push_back(Frame{f, pc, base, in->a, tailCalls});
+            f = callee;
+            base = next;
+            r = calleeRegisters;
+            k = f->constants.data();
+            list = f->operands.data();
+            pc = f->code.data();
+            depth++;
+            tailCalls = 0;
+            calls++;
+            VM_NEXT();
+        }
+        VM_CASE(TAILCALL) {
+            const BytecodeFunction* callee = &functions[in->b];
+            if (!callee->error.empty()) {
+                errorMsg = callee->error;
+                return false;
+            }
+            if (depth >= maxDepth) {
+                errorMsg = "profundidade máxima de chamadas excedida em '" + callee->name + "'";
+                return false;
+            }
+            instructions += pc - f->code.data();
+
+            // Os argumentos passam pelo espaço após o quadro e então ocupam o
+            // início do próprio quadro, que a função chamada reutiliza
+            size_t next = base + f->registers;
+            size_t needed = std::max(next + in->d, base + callee->registers);
+            if (stack.size() < needed) {
+                stack.resize(2 * needed);
+                r = stack.data() + base;
+            }
+            double* arguments = stack.data() + next;
+            for (int32_t j = 0; j < in->d; j++) arguments[j] = r[list[in->c + j]];
+            std::copy(arguments, arguments + in->d, r);
+
+            f = callee;
+            k = f->constants.data();
+            list = f->operands.data();
+            pc = f->code.data();
+            depth++;
+            tailCalls++;
+            calls++;
+            VM_NEXT();
+        }
+        VM_CASE(RETURN) {
+            // Código linear: as instruções executadas no quadro são as anteriores ao RETURN
+            instructions += pc - f->code.data();
+            double value = r[list[in->a]];
+            if (frames.empty()) {
+                result = value;
+                if (values) {
+                    for (int32_t j = 0; j < in->b; j++) values->push_back(r[list[in->a + j]]);
+                }
+                return true;
+            }
+
+            // Chamada aninhada: apenas o primeiro valor é usado
+            Frame frame = frames.back();
+            frames.pop_back();
+            depth -= 1 + tailCalls;
+            tailCalls = frame.tailCalls;
+            f = frame.func;
+            pc = frame.pc;
+            base = frame.base;
+            r = stack.data() + base;
+            k = f->constants.data();
+            list = f->operands.data();
+            r[frame.dst] = value;
+            VM_NEXT();
+        }
+    }
+    return false;
+}
+
+#if VM_THREADED_DISPATCH
+#pragma GCC diagnostic pop
+#endif
+#undef VM_CASE
+#undef VM_NEXT
+
+bool VM::call(int function, const double* args, double& result) {
+    errorMsg = "";
+    return execute(function, args, result, nullptr);
+}
+
+bool VM::call(const std::string& name, const std::vector<double>& args, double& result) {
+    std::vector<double> results;
+    bool ok = call(name, args, results);
+    result = results.empty() ? 0.0 : results[0];
+    return ok;
+}
+
+bool VM::call(const std::string& name, const std::vector<double>& args, std::vector<double>& results) {
+    errorMsg = "";
+    results.clear();
+
+    int function = this->function(name);
+    if (function < 0) {
+        errorMsg = "função '" + name + "' não existe";
+        return false;
+    }
+    if (static_cast<int>(args.size()) != functions[function].params) {
+        errorMsg = "função '" + name + "' espera " + std::to_string(functions[function].params) +
+                   " argumento(s), mas " + std::to_string(args.size()) + " foi(ram) fornecido(s)";
+        return false;
+    }
+
+    double result;
+    if (!execute(function, args.data(), result, &results)) return false;
+    if (results.empty()) results.push_back(result);
+    return true;
+}
+
+long VM::getCalls() const {
+    return calls;
+}
+
+long VM::getInstructions() const {
+    return instructions;
+}
+
+void VM::resetCounters() {
+    calls = 0;
+    instructions = 0;
+}
+
+std::string VM::getError() const {
+    return errorMsg;
+}
+
+std::string VM::disassemble() const {
+    std::ostringstream oss;
+    for (const auto& func : functions) {
+        oss << "\n=== Funcao: " << func.name << " (registradores: " << func.registers
+            << ", constantes: " << func.constants.size() << ") ===\n";
+        if (!func.error.empty()) {
+            oss << "  ; " << func.error << "\n";
+            continue;
+        }
+        for (size_t i = 0; i < func.code.size(); i++) {
+            const Instruction& in = func.code[i];
+            oss << "  " << i << ": " << opCodeName(in.op) << " ";
+            switch (in.op) {
+                case OpCode::LOADK:
+                    oss << "r" << in.a << ", " << formatNumber(func.constants[in.b]);
+                    break;
+                case OpCode::MOVE:
+                case OpCode::SQRT:
+                case OpCode::LOG:
+                    oss << "r" << in.a << ", r" << in.b;
+                    break;
+                case OpCode::FMA:
+                case OpCode::FMS:
+                case OpCode::FNMA:
+                case OpCode::MULADD:
+                case OpCode::MULSUB:
+                    oss << "r" << in.a << ", r" << in.b << ", r" << in.c << ", r" << in.d;
+                    break;
+                case OpCode::ADDK:
+                case OpCode::SUBK:
+                case OpCode::MULK:
+                case OpCode::DIVK:
+                case OpCode::POWK:
+                case OpCode::KSUB:
+                case OpCode::KDIV:
+                    oss << "r" << in.a << ", r" << in.b << ", " << formatNumber(func.constants[in.c]);
+                    break;
+                case OpCode::TAILCALL:
+                    oss << functions[in.b].name << "(";
+                    for (int32_t j = 0; j < in.d; j++) oss << (j > 0 ? ", r" : "r") << func.operands[in.c + j];
+                    oss << ")";
+                    break;
+                case OpCode::CALL:
+                    oss << "r" << in.a << ", " << functions[in.b].name << "(";
+                    for (int32_t j = 0; j < in.d; j++) oss << (j > 0 ? ", r" : "r") << func.operands[in.c + j];
+                    oss << ")";
+                    break;
+                case OpCode::RETURN:
+                    for (int32_t j = 0; j < in.b; j++) oss << (j > 0 ? ", r" : "r") << func.operands[in.a + j];
+                    break;
+                default:
+                    oss << "r" << in.a << ", r" << in.b << ", r" << in.c;
+                    break;
+            }
+            oss << "\n";
+        }
+    }
+    return oss.str();
+}
+
+std::string VM::fusionReport() const {
+    std::ostringstream oss;
+    for (auto it = fused.begin(); it != fused.end(); ++it) {
+        if (it != fused.begin()) oss << ", ";
+        oss << it->first << " " << it->second;
+    }
+    return oss.str();
+}
@@ -0,0 +1,129 @@
+#ifndef VM_H
+#define VM_H
+
+#include "codegen.h"
+#include "ir.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Despacho por goto computado (extensão do GCC e do Clang)
+#if defined(__GNUC__)
+#define VM_THREADED_DISPATCH 1
+#else
+#define VM_THREADED_DISPATCH 0
+#endif
+
+// Operações do bytecode. a, b, c e d são índices de registradores do quadro
+// da função (parâmetros primeiro), exceto onde indicado.
+enum class OpCode : uint8_t {
+    LOADK,                   // r[a] = constantes[b]
+    MOVE,                    // r[a] = r[b]
+    ADD, SUB, MUL, DIV, POW, // r[a] = r[b] op r[c]
+    SQRT, LOG,               // r[a] = op r[b]
+    FMA, FMS, FNMA,          // r[a] = op r[b], r[c], r[d]
+    CALL,                    // r[a] = funções[b](r[lista[c]], ..., r[lista[c + d - 1]])
+    RETURN,                  // retorna r[lista[a]], ..., r[lista[a + b - 1]]
+
+    // Superinstruções: sequências frequentes fundidas em uma única operação
+    MULADD, MULSUB,          // r[a] = r[b] * r[c] +/- r[d] (dois arredondamentos, como MUL e ADD)
+    ADDK, SUBK, MULK, DIVK, POWK,  // r[a] = r[b] op constantes[c]
+    KSUB, KDIV,              // r[a] = constantes[c] op r[b]
+    TAILCALL                 // CALL seguido de RETURN do resultado: reutiliza o quadro
+};
+
+struct Instruction {
+    const void* handler;     // Endereço do tratador no despacho por goto computado
+    OpCode op;
+    int32_t a, b, c, d;
+
+    Instruction(OpCode o, int32_t a = 0, int32_t b = 0, int32_t c = 0, int32_t d = 0)
+        : handler(nullptr), op(o), a(a), b(b), c(c), d(d) {}
+};
+
+struct VMOptions {
+    bool threaded;           // Goto computado (cada tratador despacha o próximo) em vez de switch
+    bool superinstructions;  // Funde sequências frequentes (MUL+ADD, LOADK+op, CALL+RETURN, op+MOVE)
+
+    VMOptions() : threaded(VM_THREADED_DISPATCH), superinstructions(true) {}
+};
+
+// Função traduzida: o quadro tem um registrador por nome (parâmetros primeiro)
+// mais os registradores que recebem constantes antes de cada operação
+struct BytecodeFunction {
+    std::string name;
+    int params;
+    int registers;                   // Tamanho do quadro
+    std::vector<Instruction> code;
+    std::vector<double> constants;
+    std::vector<int32_t> operands;   // Argumentos de CALL e valores de RETURN
+    std::string error;               // Erro de tradução, informado ao chamar a função
+
+    BytecodeFunction() : params(0), registers(0) {}
+};
+
+// Máquina virtual de registradores para o código intermediário. Cada função é
+// traduzida uma única vez para bytecode com operandos já resolvidos em índices
+// do quadro; as chamadas empilham quadros em uma pilha contígua de registradores,
+// sem recursão no C++.
+class VM {
+private:
+    // Quadro suspenso por um CALL: retorno para pc, resultado em r[dst]
+    struct Frame {
+        const BytecodeFunction* func;
+        const Instruction* pc;
+        size_t base;
+        int32_t dst;
+        int tailCalls;       // Chamadas de cauda que reutilizaram o quadro suspenso
+    };
+
+    VMOptions options;
+    std::vector<BytecodeFunction> functions;
+    std::unordered_map<std::string, int> index;
+    std::map<std::string, int> fused;   // Superinstruções criadas, por tipo
+    std::vector<double> stack;
+    std::vector<Frame> frames;
+    int maxDepth;            // Profundidade máxima de chamadas aninhadas
+    long calls;
+    long instructions;
+    std::string errorMsg;
+
+    void load(const IRModule& module);
+    void translate(const IRFunction& func, BytecodeFunction& target);
+    void fuse(BytecodeFunction& target);
+    bool execute(int function, const double* args, double& result, std::vector<double>* values);
+
+    // Laço de execução; com Threaded, entry < 0 apenas devolve a tabela de tratadores
+    template <bool Threaded>
+    bool run(int entry, const double* args, double& result, std::vector<double>* values,
+             const void* const** handlers = nullptr);
+
+public:
+    VM(const std::vector<ThreeAddressCode>& code, const VMOptions& opts = VMOptions());
+    VM(const IRModule& module, const VMOptions& opts = VMOptions());
+
+    void setMaxDepth(int depthLimit);
+
+    // Índice de uma função para chamadas repetidas sem busca pelo nome (-1 se não existe)
+    int function(const std::string& name) const;
+    int arity(int function) const;
+
+    bool call(int function, const double* args, double& result);
+    bool call(const std::string& name, const std::vector<double>& args, double& result);
+    // Todos os valores retornados (funções de gradiente: valor e derivadas parciais)
+    bool call(const std::string& name, const std::vector<double>& args, std::vector<double>& results);
+
+    long getCalls() const;          // Chamadas executadas (inclui a chamada externa)
+    long getInstructions() const;   // Instruções de bytecode executadas
+    void resetCounters();
+    std::string getError() const;
+
+    // Listagem do bytecode de todas as funções
+    std::string disassemble() const;
+    // Superinstruções criadas na tradução ("MULADD 3, ADDK 10, ...")
+    std::string fusionReport() const;
+};
+
+#endif // VM_H